@@ -17,6 +17,7 @@
 #include "Common/Parser.h"
 #include "Common/config.h"
 #include "Extension/Factory.h"
+#include "Extension/AnnexB.h"
 
 #ifdef ENABLE_MP4
 #include "mpeg4-avc.h"
@@ -50,22 +51,14 @@ bool getAVCInfo(const string &strSps, int &iVideoWidth, int &iVideoHeight, float
     return getAVCInfo(strSps.data(), strSps.size(), iVideoWidth, iVideoHeight, iVideoFps);
 }
 
-static const char *memfind(const char *buf, ssize_t len, const char *subbuf, ssize_t sublen) {
-    for (auto i = 0; i < len - sublen; ++i) {
-        if (memcmp(buf + i, subbuf, sublen) == 0) {
-            return buf + i;
-        }
-    }
-    return NULL;
-}
-
 void splitH264(
     const char *ptr, size_t len, size_t prefix, const std::function<void(const char *, size_t, size_t)> &cb) {
     auto start = ptr + prefix;
     auto end = ptr + len;
     size_t next_prefix;
     while (true) {
-        auto next_start = memfind(start, end - start, "\x00\x00\x01", 3);
+        //起始码后至少需要1个字节
+        auto next_start = findStartCode(start, end - 1);
         if (next_start) {
             //找到下一帧
             if (*(next_start - 1) == 0x00) {
@@ -41,11 +41,14 @@
 
 #include "Common/config.h"
 #include "Common/MediaSource.h"
+#include "Common/BackPressure.h"
+#include "Http/HttpBody.h"
 #include "Http/HttpSession.h"
 #include "Http/HttpRequester.h"
 #include "Player/PlayerProxy.h"
 #include "Pusher/PusherProxy.h"
 #include "Rtp/RtpSelector.h"
+#include "Rtsp/RtpMultiCaster.h"
 #include "Record/MP4Reader.h"
 
 #if defined(ENABLE_RTPPROXY)
@@ -433,6 +436,17 @@ Value makeMediaSourceJson(MediaSource &media){
                 last_loss = loss;
             }
             obj["loss"] = loss;
+            JitterBufferInfo jitter;
+            if (media.getJitterBufferInfo(codec_type, jitter)) {
+                auto &item = obj["jitter_buffer"];
+                item["window_size"] = (Json::UInt64)jitter.window_size;
+                item["window_ms"] = (Json::UInt64)jitter.window_ms;
+                item["reorder_depth"] = (Json::UInt64)jitter.reorder_depth;
+                item["jitter_ms"] = jitter.jitter_ms;
+                item["cached"] = (Json::UInt64)jitter.cached;
+                item["drop_count"] = (Json::UInt64)jitter.drop_count;
+                item["late_count"] = (Json::UInt64)jitter.late_count;
+            }
         }
         obj["frames"] = track->getFrames();
         obj["duration"] = track->getDuration();
@@ -512,6 +526,14 @@ void getStatisticJson(const function<void(Value &val)> &cb) {
 
     val["RtpPacket"] = (Json::UInt64)(ObjectStatistic<RtpPacket>::count());
     val["RtmpPacket"] = (Json::UInt64)(ObjectStatistic<RtmpPacket>::count());
+
+    auto &mmap_statistic = getMmapCacheStatistic();
+    auto &mmap_cache = val["MmapCache"];
+    mmap_cache["hits"] = (Json::UInt64)mmap_statistic.hits.load();
+    mmap_cache["misses"] = (Json::UInt64)mmap_statistic.misses.load();
+    mmap_cache["invalidations"] = (Json::UInt64)mmap_statistic.invalidations.load();
+    mmap_cache["evictions"] = (Json::UInt64)mmap_statistic.evictions.load();
+    mmap_cache["bytes"] = (Json::Int64)mmap_statistic.bytes.load();
 #ifdef ENABLE_MEM_DEBUG
     auto bytes = getTotalMemUsage();
     val["totalMemUsage"] = (Json::UInt64) bytes;
@@ -897,12 +919,45 @@ void installWebApi() {
                 auto &sock = info.get<SockInfo>();
                 fillSockInfo(*obj, &sock);
                 (*obj)["typeid"] = toolkit::demangle(typeid(sock).name());
+                // 该回调在播放器所在线程执行，可以安全读取背压统计
+                if (auto session = dynamic_cast<BackPressureSession *>(&sock)) {
+                    auto &back_pressure = session->getBackPressure();
+                    auto &item = (*obj)["back_pressure"];
+                    item["policy"] = back_pressure.getPolicy();
+                    item["queue_bytes"] = (Json::UInt64)back_pressure.getQueueBytes();
+                    item["queue_ms"] = (Json::UInt64)back_pressure.getQueueMS();
+                    item["overflow_count"] = (Json::UInt64)back_pressure.getOverflowCount();
+                    item["drop_bytes"] = (Json::UInt64)back_pressure.getDropBytes();
+                    item["drop_count"] = (Json::UInt64)back_pressure.getDropCount();
+                    item["dropping"] = back_pressure.isDropping();
+                }
                 toolkit::Any ret;
                 ret.set(obj);
                 return ret;
             });
     });
 
+    //获取rtsp组播组列表及发送统计
+    //测试url http://127.0.0.1/index/api/getMultiCasterList
+    api_regist("/index/api/getMultiCasterList",[](API_ARGS_MAP){
+        CHECK_SECRET();
+        val["data"] = Value(arrayValue);
+        RtpMultiCaster::for_each([&](const RtpMultiCaster::Ptr &caster) {
+            Value obj;
+            obj["stream"] = caster->getStreamId();
+            obj["ip"] = caster->getMultiCasterIP();
+            for (auto type : { TrackVideo, TrackAudio }) {
+                auto &statistic = caster->getStatistic(type);
+                auto &item = obj[getTrackString(type)];
+                item["port"] = caster->getMultiCasterPort(type);
+                item["packets"] = (Json::UInt64)statistic.packets.load();
+                item["bytes"] = (Json::UInt64)statistic.bytes.load();
+                item["gso_send_errors"] = (Json::UInt64)statistic.gso_send_errors.load();
+            }
+            val["data"].append(std::move(obj));
+        });
+    });
+
     api_regist("/index/api/broadcastMessage", [](API_ARGS_MAP) {
         CHECK_SECRET();
         CHECK_ARGS("schema", "vhost", "app", "stream", "msg");
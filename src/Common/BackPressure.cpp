@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "BackPressure.h"
+#include "Common/config.h"
+#include "Util/logger.h"
+
+using namespace toolkit;
+
+namespace mediakit {
+
+BackPressure::BackPressure() {
+    GET_CONFIG(int, policy, General::kPlayerQueuePolicy);
+    GET_CONFIG(size_t, max_kb, General::kPlayerQueueMaxKB);
+    GET_CONFIG(uint64_t, max_ms, General::kPlayerQueueMaxMS);
+    _policy = policy;
+    _max_bytes = max_kb * 1024;
+    _max_ms = max_ms;
+}
+
+void BackPressure::onDropVideo(size_t bytes) {
+    _drop_bytes += bytes;
+}
+
+BackPressure::Action BackPressure::check(SocketHelper &sock, size_t bytes, bool key_pos, bool split_audio) {
+    if (!sock.isSocketBusy()) {
+        // socket可写，用户态发送队列已经清空
+        _queue_bytes = 0;
+        _queue_ms = 0;
+    } else {
+        // socket发送缓存已满，统计上次发送成功至今的时长
+        _queue_ms = sock.getSock()->elapsedTimeAfterFlushed();
+    }
+
+    auto overflow = (_max_bytes && _queue_bytes + bytes > _max_bytes) || (_max_ms && _queue_ms > _max_ms);
+    if (overflow && !_dropping) {
+        ++_overflow_count;
+        if (_policy == kPolicyDisconnect) {
+            return kActionDisconnect;
+        }
+        if (_policy == kPolicyDropToKeyFrame || _policy == kPolicyAudioOnly) {
+            WarnL << "Player send queue overflow, start dropping: " << sock.getIdentifier() << ", queue bytes: " << _queue_bytes
+                  << ", queue ms: " << _queue_ms;
+            _dropping = true;
+        }
+    }
+
+    if (_dropping) {
+        if (!key_pos || overflow) {
+            if (_policy == kPolicyAudioOnly && split_audio) {
+                // 音频数据较小，继续发送音频，视频在调用方统计丢弃
+                ++_drop_count;
+                return kActionSendAudio;
+            }
+            _drop_bytes += bytes;
+            ++_drop_count;
+            return kActionDrop;
+        }
+        // 发送队列已恢复且遇到关键帧，恢复发送
+        _dropping = false;
+    }
+
+    if (sock.isSocketBusy()) {
+        _queue_bytes += bytes;
+    }
+    return kActionSend;
+}
+
+} // namespace mediakit
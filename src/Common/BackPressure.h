@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_BACK_PRESSURE_H
+#define ZLMEDIAKIT_BACK_PRESSURE_H
+
+#include <cstdint>
+#include "Network/Socket.h"
+
+namespace mediakit {
+
+/// 播放器发送队列背压控制，每个播放器(RingReader)一个实例，只能在播放器所在线程使用
+/// 当socket发送缓存被填满后，其后写入的数据将堆积在用户态发送队列中，
+/// 慢速播放器(例如3G网络)会持续堆积直至超时，本类按队列字节数与堆积时长限制其上限;
+/// 上限与策略来自全局配置，所有播放器相同；只用于tcp播放(rtsp over tcp、rtmp、http/ws-flv/ts/fmp4)，rtsp over udp不检查
+class BackPressure {
+public:
+    enum Policy {
+        // 不做控制，只统计
+        kPolicyNone = 0,
+        // 丢弃所有数据，直到下一个关键帧
+        kPolicyDropToKeyFrame = 1,
+        // 丢弃所有视频但保留音频，直到下一个关键帧(不区分参考帧与非参考帧)
+        kPolicyAudioOnly = 2,
+        // 断开播放器
+        kPolicyDisconnect = 3,
+    };
+
+    enum Action {
+        // 发送全部数据
+        kActionSend = 0,
+        // 丢弃全部数据
+        kActionDrop,
+        // 只发送音频数据
+        kActionSendAudio,
+        // 断开播放器
+        kActionDisconnect,
+    };
+
+    BackPressure();
+
+    /**
+     * 收到环形缓存中的合并写包列表时调用，判断该如何发送
+     * @param sock 播放器会话
+     * @param list 合并写包列表
+     * @param split_audio 是否能区分包列表中的音视频数据(ts/fmp4为复用后的数据，无法区分)
+     */
+    template<typename LIST>
+    Action check(toolkit::SocketHelper &sock, const LIST &list, bool split_audio = true) {
+        size_t bytes = 0;
+        list->for_each([&](const typename LIST::element_type::value_type &pkt) { bytes += pkt->size(); });
+        return check(sock, bytes, list->key_pos, split_audio);
+    }
+
+    /**
+     * kActionSendAudio时，统计被丢弃的视频数据
+     */
+    void onDropVideo(size_t bytes);
+
+    int getPolicy() const { return _policy; }
+    // 当前堆积在发送队列中的字节数(估算值)
+    size_t getQueueBytes() const { return _queue_bytes; }
+    // 当前发送队列堆积时长
+    uint64_t getQueueMS() const { return _queue_ms; }
+    // 发送队列超过上限的次数
+    uint64_t getOverflowCount() const { return _overflow_count; }
+    // 丢弃的字节数
+    uint64_t getDropBytes() const { return _drop_bytes; }
+    // 丢弃的合并写包列表个数
+    uint64_t getDropCount() const { return _drop_count; }
+    // 是否正在丢包
+    bool isDropping() const { return _dropping; }
+
+private:
+    Action check(toolkit::SocketHelper &sock, size_t bytes, bool key_pos, bool split_audio);
+
+private:
+    bool _dropping = false;
+    int _policy;
+    size_t _max_bytes;
+    uint64_t _max_ms;
+    size_t _queue_bytes = 0;
+    uint64_t _queue_ms = 0;
+    uint64_t _overflow_count = 0;
+    uint64_t _drop_bytes = 0;
+    uint64_t _drop_count = 0;
+};
+
+/// 支持背压控制的播放器会话，getMediaPlayerList接口通过该接口获取背压统计
+class BackPressureSession {
+public:
+    virtual ~BackPressureSession() = default;
+    virtual const BackPressure &getBackPressure() const = 0;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_BACK_PRESSURE_H
@@ -28,12 +28,135 @@ namespace toolkit {
 
 namespace mediakit {
 
-static recursive_mutex s_media_source_mtx;
-using StreamMap = unordered_map<string/*strema_id*/, weak_ptr<MediaSource> >;
-using AppStreamMap = unordered_map<string/*app*/, StreamMap>;
-using VhostAppStreamMap = unordered_map<string/*vhost*/, AppStreamMap>;
-using SchemaVhostAppStreamMap = unordered_map<string/*schema*/, VhostAppStreamMap>;
-static SchemaVhostAppStreamMap s_media_source_map;
+// 不指定schema查找流时的协议优先级
+static const char *s_schema_priority[] = { RTMP_SCHEMA, RTSP_SCHEMA, TS_SCHEMA, FMP4_SCHEMA, HLS_SCHEMA, HLS_FMP4_SCHEMA };
+static constexpr size_t kSchemaPriorityCount = sizeof(s_schema_priority) / sizeof(s_schema_priority[0]);
+
+// 同一个流(vhost/app/stream)下所有协议的媒体源，
+// 一次哈希查找即可获知该流有哪些协议在线
+class MediaSourceEntry {
+public:
+    MediaSourceEntry(const string &vhost, const string &app, const string &stream) : _tuple { vhost, app, stream, "" } {}
+
+    const MediaTuple &getMediaTuple() const { return _tuple; }
+
+    weak_ptr<MediaSource> &at(const string &schema) {
+        auto index = getSchemaIndex(schema);
+        return index < kSchemaPriorityCount ? _sources[index] : _others[schema];
+    }
+
+    // schema为空时按优先级返回第一个在线的媒体源
+    MediaSource::Ptr get(const string &schema) const {
+        if (!schema.empty()) {
+            auto index = getSchemaIndex(schema);
+            if (index < kSchemaPriorityCount) {
+                return _sources[index].lock();
+            }
+            auto it = _others.find(schema);
+            return it == _others.end() ? nullptr : it->second.lock();
+        }
+        for (auto &ref : _sources) {
+            if (auto src = ref.lock()) {
+                return src;
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename LIST>
+    void for_each(LIST &list, const string &schema) const {
+        if (!schema.empty()) {
+            if (auto src = get(schema)) {
+                list.emplace_back(std::move(src));
+            }
+            return;
+        }
+        for (auto &ref : _sources) {
+            if (auto src = ref.lock()) {
+                list.emplace_back(std::move(src));
+            }
+        }
+        for (auto &pr : _others) {
+            if (auto src = pr.second.lock()) {
+                list.emplace_back(std::move(src));
+            }
+        }
+    }
+
+    // 对象已经销毁或者对象就是自己，那么移除之
+    bool erase(const string &schema, const MediaSource *thiz) {
+        auto index = getSchemaIndex(schema);
+        if (index < kSchemaPriorityCount) {
+            auto src = _sources[index].lock();
+            if (!src || src.get() == thiz) {
+                _sources[index].reset();
+                return true;
+            }
+            return false;
+        }
+        auto it = _others.find(schema);
+        if (it == _others.end()) {
+            return false;
+        }
+        auto src = it->second.lock();
+        if (!src || src.get() == thiz) {
+            _others.erase(it);
+            return true;
+        }
+        return false;
+    }
+
+    bool empty() const {
+        for (auto &ref : _sources) {
+            if (!ref.expired()) {
+                return false;
+            }
+        }
+        return _others.empty();
+    }
+
+private:
+    static size_t getSchemaIndex(const string &schema) {
+        for (size_t i = 0; i < kSchemaPriorityCount; ++i) {
+            if (schema == s_schema_priority[i]) {
+                return i;
+            }
+        }
+        return kSchemaPriorityCount;
+    }
+
+private:
+    MediaTuple _tuple;
+    weak_ptr<MediaSource> _sources[kSchemaPriorityCount];
+    unordered_map<string/*schema*/, weak_ptr<MediaSource> > _others;
+};
+
+// 媒体源注册表按vhost/app/stream哈希分片，每个分片一把锁，
+// 这样不同流的查找、注册、注销不会在同一把全局锁上竞争;
+// 锁内可能释放最后一个强引用触发MediaSource析构并重入unregist，所以仍使用递归锁
+class MediaSourceShard {
+public:
+    recursive_mutex mtx;
+    unordered_map<string/*vhost\0app\0stream*/, MediaSourceEntry> map;
+};
+
+static constexpr size_t kMediaSourceShardCount = 64;
+static MediaSourceShard s_media_source_shards[kMediaSourceShardCount];
+
+static string getMediaSourceKey(const string &vhost, const string &app, const string &stream) {
+    // app与stream_id中可能包含'/'，使用不会出现在其中的'\0'分隔，防止("a", "b/c")与("a/b", "c")冲突
+    string key;
+    key.reserve(vhost.size() + app.size() + stream.size() + 2);
+    key.append(vhost).push_back('\0');
+    key.append(app).push_back('\0');
+    key.append(stream);
+    return key;
+}
+
+static MediaSourceShard &getMediaSourceShard(const string &key) {
+    // 同一个流的所有协议落在同一分片
+    return s_media_source_shards[hash<string>()(key) % kMediaSourceShardCount];
+}
 
 string getOriginTypeString(MediaOriginType type){
 #define SWITCH_CASE(type) case MediaOriginType::type : return #type
@@ -75,6 +198,7 @@ ProtocolOption::ProtocolOption() {
     GET_CONFIG(bool, s_rtmp_demand, Protocol::kRtmpDemand);
     GET_CONFIG(bool, s_ts_demand, Protocol::kTSDemand);
     GET_CONFIG(bool, s_fmp4_demand, Protocol::kFMP4Demand);
+    GET_CONFIG(bool, s_warm_idle, Protocol::kWarmIdle);
 
     GET_CONFIG(bool, s_mp4_as_player, Protocol::kMP4AsPlayer);
     GET_CONFIG(uint32_t, s_mp4_max_second, Protocol::kMP4MaxSecond);
@@ -102,6 +226,7 @@ ProtocolOption::ProtocolOption() {
     rtmp_demand = s_rtmp_demand;
     ts_demand = s_ts_demand;
     fmp4_demand = s_fmp4_demand;
+    warm_idle = s_warm_idle;
 
     mp4_as_player = s_mp4_as_player;
     mp4_max_second = s_mp4_max_second;
@@ -262,6 +387,14 @@ float MediaSource::getLossRate(mediakit::TrackType type) {
     return listener->getLossRate(*this, type);
 }
 
+bool MediaSource::getJitterBufferInfo(mediakit::TrackType type, JitterBufferInfo &info) {
+    auto listener = _listener.lock();
+    if (!listener) {
+        return false;
+    }
+    return listener->getJitterBufferInfo(*this, type, info);
+}
+
 toolkit::EventPoller::Ptr MediaSource::getOwnerPoller() {
     toolkit::EventPoller::Ptr ret;
     auto listener = _listener.lock();
@@ -332,40 +465,8 @@ bool MediaSource::stopSendRtp(const string &ssrc) {
     return listener->stopSendRtp(*this, ssrc);
 }
 
-template<typename MAP, typename LIST, typename First, typename ...KeyTypes>
-static void for_each_media_l(const MAP &map, LIST &list, const First &first, const KeyTypes &...keys) {
-    if (first.empty()) {
-        for (auto &pr : map) {
-            for_each_media_l(pr.second, list, keys...);
-        }
-        return;
-    }
-    auto it = map.find(first);
-    if (it != map.end()) {
-        for_each_media_l(it->second, list, keys...);
-    }
-}
-
-template<typename LIST, typename Ptr>
-static void emplace_back(LIST &list, const Ptr &ptr) {
-    auto src = ptr.lock();
-    if (src) {
-        list.emplace_back(std::move(src));
-    }
-}
-
-template<typename MAP, typename LIST, typename First>
-static void for_each_media_l(const MAP &map, LIST &list, const First &first) {
-    if (first.empty()) {
-        for (auto &pr : map) {
-            emplace_back(list, pr.second);
-        }
-        return;
-    }
-    auto it = map.find(first);
-    if (it != map.end()) {
-        emplace_back(list, it->second);
-    }
+static bool matchMediaTuple(const MediaTuple &tuple, const string &vhost, const string &app, const string &stream) {
+    return (vhost.empty() || tuple.vhost == vhost) && (app.empty() || tuple.app == app) && (stream.empty() || tuple.stream == stream);
 }
 
 void MediaSource::for_each_media(const function<void(const Ptr &src)> &cb,
@@ -374,15 +475,45 @@ void MediaSource::for_each_media(const function<void(const Ptr &src)> &cb,
                                  const string &app,
                                  const string &stream) {
     deque<Ptr> src_list;
-    {
-        lock_guard<recursive_mutex> lock(s_media_source_mtx);
-        for_each_media_l(s_media_source_map, src_list, schema, vhost, app, stream);
+    if (!vhost.empty() && !app.empty() && !stream.empty()) {
+        // 精确查找，只需锁定一个分片
+        auto key = getMediaSourceKey(vhost, app, stream);
+        auto &shard = getMediaSourceShard(key);
+        lock_guard<recursive_mutex> lock(shard.mtx);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end()) {
+            it->second.for_each(src_list, schema);
+        }
+    } else {
+        // 模糊遍历，逐个分片加锁，不同时持有多把锁
+        for (auto &shard : s_media_source_shards) {
+            lock_guard<recursive_mutex> lock(shard.mtx);
+            for (auto &pr : shard.map) {
+                if (matchMediaTuple(pr.second.getMediaTuple(), vhost, app, stream)) {
+                    pr.second.for_each(src_list, schema);
+                }
+            }
+        }
     }
     for (auto &src : src_list) {
         cb(src);
     }
 }
 
+static MediaSource::Ptr findEntry_l(const string &schema, const string &vhost, const string &app, const string &id) {
+    auto key = getMediaSourceKey(vhost, app, id);
+    auto &shard = getMediaSourceShard(key);
+    MediaSource::Ptr ret;
+    {
+        lock_guard<recursive_mutex> lock(shard.mtx);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end()) {
+            ret = it->second.get(schema);
+        }
+    }
+    return ret;
+}
+
 static MediaSource::Ptr find_l(const string &schema, const string &vhost_in, const string &app, const string &id, bool from_mp4) {
     string vhost = vhost_in;
     GET_CONFIG(bool, enableVhost, General::kEnableVhost);
@@ -395,13 +526,13 @@ static MediaSource::Ptr find_l(const string &schema, const string &vhost_in, con
         return nullptr;
     }
 
-    MediaSource::Ptr ret;
-    MediaSource::for_each_media([&](const MediaSource::Ptr &src) { ret = std::move(const_cast<MediaSource::Ptr &>(src)); }, schema, vhost, app, id);
+    // schema为空时按协议优先级查找
+    auto ret = findEntry_l(schema, vhost, app, id);
 
     if(!ret && from_mp4 && schema != HLS_SCHEMA){
         //未找到媒体源，则读取mp4创建一个
         //播放hls不触发mp4点播(因为HLS也可以用于录像，不是纯粹的直播)
-        ret = MediaSource::createFromMP4(schema, vhost, app, id);
+        ret = MediaSource::createFromMP4(schema.empty() ? RTMP_SCHEMA : schema, vhost, app, id);
     }
     return ret;
 }
@@ -483,27 +614,9 @@ MediaSource::Ptr MediaSource::find(const string &schema, const string &vhost, co
 }
 
 MediaSource::Ptr MediaSource::find(const string &vhost, const string &app, const string &stream_id, bool from_mp4) {
-    auto src = MediaSource::find(RTMP_SCHEMA, vhost, app, stream_id, from_mp4);
-    if (src) {
-        return src;
-    }
-    src = MediaSource::find(RTSP_SCHEMA, vhost, app, stream_id, from_mp4);
-    if (src) {
-        return src;
-    }
-    src = MediaSource::find(TS_SCHEMA, vhost, app, stream_id, from_mp4);
-    if (src) {
-        return src;
-    }
-    src = MediaSource::find(FMP4_SCHEMA, vhost, app, stream_id, from_mp4);
-    if (src) {
-        return src;
-    }
-    src = MediaSource::find(HLS_SCHEMA, vhost, app, stream_id, from_mp4);
-    if (src) {
-        return src;
-    }
-    return MediaSource::find(HLS_FMP4_SCHEMA, vhost, app, stream_id, from_mp4);
+    // 一次查找获取该流所有协议，按rtmp/rtsp/ts/fmp4/hls/hls.fmp4优先级返回；
+    // 都不在线时从mp4点播生成rtmp源
+    return find_l("", vhost, app, stream_id, from_mp4);
 }
 
 void MediaSource::emitEvent(bool regist){
@@ -520,8 +633,14 @@ void MediaSource::emitEvent(bool regist){
 void MediaSource::regist() {
     {
         //减小互斥锁临界区
-        lock_guard<recursive_mutex> lock(s_media_source_mtx);
-        auto &ref = s_media_source_map[_schema][_tuple.vhost][_tuple.app][_tuple.stream];
+        auto key = getMediaSourceKey(_tuple.vhost, _tuple.app, _tuple.stream);
+        auto &shard = getMediaSourceShard(key);
+        lock_guard<recursive_mutex> lock(shard.mtx);
+        auto it = shard.map.find(key);
+        if (it == shard.map.end()) {
+            it = shard.map.emplace(key, MediaSourceEntry(_tuple.vhost, _tuple.app, _tuple.stream)).first;
+        }
+        auto &ref = it->second.at(_schema);
         auto src = ref.lock();
         if (src) {
             if (src.get() == this) {
@@ -535,36 +654,23 @@ void MediaSource::regist() {
     emitEvent(true);
 }
 
-template<typename MAP, typename First, typename ...KeyTypes>
-static bool erase_media_source(bool &hit, const MediaSource *thiz, MAP &map, const First &first, const KeyTypes &...keys) {
-    auto it = map.find(first);
-    if (it != map.end() && erase_media_source(hit, thiz, it->second, keys...)) {
-        map.erase(it);
-    }
-    return map.empty();
-}
-
-template<typename MAP, typename First>
-static bool erase_media_source(bool &hit, const MediaSource *thiz, MAP &map, const First &first) {
-    auto it = map.find(first);
-    if (it != map.end()) {
-        auto src = it->second.lock();
-        if (!src || src.get() == thiz) {
-            //对象已经销毁或者对象就是自己，那么移除之
-            map.erase(it);
-            hit = true;
-        }
-    }
-    return map.empty();
-}
-
 //反注册该源
 bool MediaSource::unregist() {
     bool ret = false;
     {
         //减小互斥锁临界区
-        lock_guard<recursive_mutex> lock(s_media_source_mtx);
-        erase_media_source(ret, this, s_media_source_map, _schema, _tuple.vhost, _tuple.app, _tuple.stream);
+        auto key = getMediaSourceKey(_tuple.vhost, _tuple.app, _tuple.stream);
+        auto &shard = getMediaSourceShard(key);
+        lock_guard<recursive_mutex> lock(shard.mtx);
+        auto it = shard.map.find(key);
+        if (it != shard.map.end()) {
+            ret = it->second.erase(_schema, this);
+            // erase时可能释放其他媒体源的最后引用并重入unregist，所以重新查找
+            it = shard.map.find(key);
+        }
+        if (it != shard.map.end() && it->second.empty()) {
+            shard.map.erase(it);
+        }
     }
 
     if (ret) {
@@ -791,6 +897,14 @@ float MediaSourceEventInterceptor::getLossRate(MediaSource &sender, TrackType ty
     return -1; //异常返回-1
 }
 
+bool MediaSourceEventInterceptor::getJitterBufferInfo(MediaSource &sender, TrackType type, JitterBufferInfo &info) {
+    auto listener = _listener.lock();
+    if (listener) {
+        return listener->getJitterBufferInfo(sender, type, info);
+    }
+    return false;
+}
+
 toolkit::EventPoller::Ptr MediaSourceEventInterceptor::getOwnerPoller(MediaSource &sender) {
     auto listener = _listener.lock();
     if (listener) {
@@ -40,6 +40,24 @@ enum class MediaOriginType : uint8_t {
 
 std::string getOriginTypeString(MediaOriginType type);
 
+// rtp排序(抖动)缓存状态
+struct JitterBufferInfo {
+    // 当前排序窗口，单位包个数
+    size_t window_size = 0;
+    // 当前排序最大等待时间，单位毫秒
+    size_t window_ms = 0;
+    // 实测乱序深度，单位包个数
+    size_t reorder_depth = 0;
+    // 网络抖动，单位毫秒
+    double jitter_ms = 0;
+    // 当前缓存的包个数
+    size_t cached = 0;
+    // 放弃等待而跳过的丢包个数
+    uint64_t drop_count = 0;
+    // 迟到而被丢弃的包个数
+    uint64_t late_count = 0;
+};
+
 class MediaSource;
 class MultiMediaSourceMuxer;
 class MediaSourceEvent {
@@ -77,6 +95,8 @@ public:
     virtual void onRegist(MediaSource &sender, bool regist) {}
     // 获取丢包率
     virtual float getLossRate(MediaSource &sender, TrackType type) { return -1; }
+    // 获取rtp排序缓存状态
+    virtual bool getJitterBufferInfo(MediaSource &sender, TrackType type, JitterBufferInfo &info) { return false; }
     // 获取所在线程, 此函数一般强制重载
     virtual toolkit::EventPoller::Ptr getOwnerPoller(MediaSource &sender) { throw NotImplemented(toolkit::demangle(typeid(*this).name()) + "::getOwnerPoller not implemented"); }
 
@@ -198,6 +218,8 @@ public:
     bool ts_demand;
     // http[s]-fmp4、ws[s]-fmp4协议是否按需生成
     bool fmp4_demand;
+    // 是否开启warm-idle模式(无人观看时只保留配置帧与最近一个关键帧)
+    bool warm_idle;
 
     //是否将mp4录制当做观看者
     bool mp4_as_player;
@@ -243,6 +265,7 @@ public:
         GET_OPT_VALUE(rtmp_demand);
         GET_OPT_VALUE(ts_demand);
         GET_OPT_VALUE(fmp4_demand);
+        GET_OPT_VALUE(warm_idle);
 
         GET_OPT_VALUE(mp4_max_second);
         GET_OPT_VALUE(mp4_as_player);
@@ -277,6 +300,7 @@ public:
     void startSendRtp(MediaSource &sender, const SendRtpArgs &args, const std::function<void(uint16_t, const toolkit::SockException &)> cb) override;
     bool stopSendRtp(MediaSource &sender, const std::string &ssrc) override;
     float getLossRate(MediaSource &sender, TrackType type) override;
+    bool getJitterBufferInfo(MediaSource &sender, TrackType type, JitterBufferInfo &info) override;
     toolkit::EventPoller::Ptr getOwnerPoller(MediaSource &sender) override;
     std::shared_ptr<MultiMediaSourceMuxer> getMuxer(MediaSource &sender) override;
 
@@ -392,6 +416,8 @@ public:
     bool stopSendRtp(const std::string &ssrc);
     // 获取丢包率
     float getLossRate(mediakit::TrackType type);
+    // 获取rtp排序缓存状态
+    bool getJitterBufferInfo(mediakit::TrackType type, JitterBufferInfo &info);
     // 获取所在线程
     toolkit::EventPoller::Ptr getOwnerPoller();
     // 获取MultiMediaSourceMuxer对象
@@ -550,14 +550,15 @@ void MultiMediaSourceMuxer::onAllTrackReady() {
     }
 #endif
 
+    // 按track索引顺序遍历，未指定索引时视频track在前，音频同步于视频
     Stamp *first = nullptr;
-    for (auto &pr : _stamps) {
+    _stamps.for_each([&](int index, Stamp &stamp) {
         if (!first) {
-            first = &pr.second;
+            first = &stamp;
         } else {
-            pr.second.syncTo(*first);
+            stamp.syncTo(*first);
         }
-    }
+    });
     InfoL << "stream: " << shortUrl() << " , codec info: " << getTrackInfoStr(this);
 }
 
@@ -607,7 +608,7 @@ bool MultiMediaSourceMuxer::onTrackFrame(const Frame::Ptr &frame_in) {
     auto frame = frame_in;
     if (_option.modify_stamp != ProtocolOption::kModifyStampOff) {
         // 时间戳不采用原始的绝对时间戳
-        frame = std::make_shared<FrameStamp>(frame, _stamps[frame->getIndex()], _option.modify_stamp);
+        frame = makeFrame<FrameStamp>(frame, _stamps[frame->getIndex()], _option.modify_stamp);
     }
     return _paced_sender ? _paced_sender->inputFrame(frame) : onTrackFrame_l(frame);
 }
@@ -169,7 +169,7 @@ private:
     MediaTuple _tuple;
     ProtocolOption _option;
     toolkit::Ticker _last_check;
-    std::unordered_map<int, Stamp> _stamps;
+    StampSet _stamps;
     std::weak_ptr<Listener> _track_listener;
     std::unordered_multimap<std::string, RingType::RingReader::Ptr> _rtp_sender;
     FMP4MediaSourceMuxer::Ptr _fmp4;
@@ -11,8 +11,12 @@
 #ifndef ZLMEDIAKIT_PACKET_CACHE_H_
 #define ZLMEDIAKIT_PACKET_CACHE_H_
 
+#include <vector>
 #include "Common/config.h"
 #include "Util/List.h"
+#include "Util/logger.h"
+#include "Util/ResourcePool.h"
+#include "Extension/Frame.h"
 
 namespace mediakit {
 /// 缓存刷新策略类
@@ -25,14 +29,41 @@ private:
     uint64_t _last_stamp[2] = { 0, 0 };
 };
 
+/// 合并写包列表，采用连续内存存放，clear后保留容量以便回收复用
+/// 接口与toolkit::List保持一致(for_each/size/empty)
+template<typename T>
+class PacketList : public std::vector<T> {
+public:
+    // 是否包含关键帧(无视频时恒为true)，由媒体源写入环形缓存前设置，供播放器背压控制使用
+    bool key_pos = false;
+
+    template<typename FUNC>
+    void for_each(FUNC &&func) {
+        for (auto &t : *this) {
+            func(t);
+        }
+    }
+
+    template<typename FUNC>
+    void for_each(FUNC &&func) const {
+        for (auto &t : *this) {
+            func(t);
+        }
+    }
+};
+
 /// 合并写缓存模板
 /// \tparam packet 包类型
 /// \tparam policy 刷新缓存策略
 /// \tparam packet_list 包缓存类型
-template<typename packet, typename policy = FlushPolicy, typename packet_list = toolkit::List<std::shared_ptr<packet> > >
+template<typename packet, typename policy = FlushPolicy, typename packet_list = PacketList<std::shared_ptr<packet> > >
 class PacketCache {
 public:
-    PacketCache() { _cache = std::make_shared<packet_list>(); }
+    PacketCache() {
+        // 包列表回收池大小，一般能覆盖一个gop内的合并写次数
+        _list_pool.setSize(64);
+        _cache = obtainList();
+    }
 
     virtual ~PacketCache() = default;
 
@@ -58,7 +89,7 @@ public:
             return;
         }
         onFlush(std::move(_cache), _key_pos);
-        _cache = std::make_shared<packet_list>();
+        _cache = obtainList();
         _key_pos = false;
     }
 
@@ -69,6 +100,14 @@ public:
     virtual void onFlush(std::shared_ptr<packet_list>, bool key_pos) = 0;
 
 private:
+    std::shared_ptr<packet_list> obtainList() {
+        // 列表被所有播放器以及gop缓存释放后回收，回收时立即释放其中的包，但保留列表容量
+        return _list_pool.obtain([](packet_list *list) {
+            list->clear();
+            list->key_pos = false;
+        });
+    }
+
     bool flushImmediatelyWhenCloseMerge() {
         // 一般的协议关闭合并写时，立即刷新缓存，这样可以减少一帧的延时，但是rtp例外
         // 因为rtp的包很小，一个RtpPacket包中也不是完整的一帧图像，所以在关闭合并写时，
@@ -84,7 +123,84 @@ private:
     bool _key_pos = false;
     policy _policy;
     std::shared_ptr<packet_list> _cache;
+    toolkit::ResourcePool<packet_list> _list_pool;
 };
+
+/// 最近一个关键帧缓存(包括其前面的配置帧)，warm-idle模式下协议muxer无人观看时使用
+class FrameKeyCache {
+public:
+    void inputFrame(const Frame::Ptr &frame) {
+        if (frame->getTrackType() != TrackVideo) {
+            return;
+        }
+        auto video_key_pos = frame->keyFrame() || frame->configFrame();
+        if (video_key_pos && !_video_key_pos) {
+            // 新的关键帧开始，丢弃上一个关键帧
+            _cache.clear();
+        }
+        if (video_key_pos) {
+            _cache.emplace_back(Frame::getCacheAbleFrame(frame));
+        }
+        if (!frame->dropAble()) {
+            _video_key_pos = video_key_pos;
+        }
+    }
+
+    template<typename FUNC>
+    void for_each(FUNC &&func) const {
+        _cache.for_each(std::forward<FUNC>(func));
+    }
+
+    bool empty() const { return _cache.empty(); }
+
+    void clear() { _cache.clear(); }
+
+private:
+    bool _video_key_pos = false;
+    toolkit::List<Frame::Ptr> _cache;
+};
+
+/// warm-idle模式下协议muxer的输入控制，协议媒体源注册后无人观看时不再打包并清空其gop缓存，
+/// 只保留配置帧与最近一个关键帧，首个播放器到来时先打包该关键帧，
+/// 随后丢弃视频非关键帧直到下一个关键帧(避免花屏)，恢复开销为O(1)
+class WarmIdleHelper {
+public:
+    void enable(bool enable) { _enabled = enable; }
+
+    bool enabled() const { return _enabled; }
+
+    template<typename SRC, typename FUNC>
+    bool inputFrame(const SRC &src, const Frame::Ptr &frame, FUNC &&input) {
+        if (src->getRing() && !src->readerCount()) {
+            if (!_idle) {
+                _idle = true;
+                src->clearCache();
+            }
+            _key_cache.inputFrame(frame);
+            return false;
+        }
+        if (_idle) {
+            _idle = false;
+            _key_cache.for_each([&](const Frame::Ptr &key_frame) { input(key_frame); });
+            _key_cache.clear();
+            _wait_key_frame = true;
+        }
+        if (_wait_key_frame && frame->getTrackType() == TrackVideo) {
+            if (!frame->keyFrame() && !frame->configFrame()) {
+                return false;
+            }
+            _wait_key_frame = false;
+        }
+        return input(frame);
+    }
+
+private:
+    bool _idle = false;
+    bool _enabled = false;
+    bool _wait_key_frame = false;
+    FrameKeyCache _key_cache;
+};
+
 }
 
 #endif //ZLMEDIAKIT_PACKET_CACHE_H_
@@ -13,6 +13,7 @@
 
 #include <set>
 #include <cstdint>
+#include <unordered_map>
 #include "Util/TimeTicker.h"
 
 namespace mediakit {
@@ -109,6 +110,42 @@ private:
     Stamp *_sync_master = nullptr;
 };
 
+//按track索引存放的时间戳修正器集合
+//常用的track索引(未指定索引时即为TrackType)采用数组直接寻址，避免每帧哈希查找，其他索引存放于哈希表
+//元素地址在生命周期内保持不变(syncTo保存了对方地址)
+class StampSet {
+public:
+    //数组直接寻址的track索引上限
+    static constexpr int kFlatSize = 4;
+
+    //获取track对应的时间戳修正器，不存在时创建
+    Stamp &operator[](int index) {
+        if (index >= 0 && index < kFlatSize) {
+            _used[index] = true;
+            return _flat[index];
+        }
+        return _others[index];
+    }
+
+    //按track索引从小到大遍历(哈希表中的索引除外)
+    template<typename FUNC>
+    void for_each(FUNC &&func) {
+        for (int i = 0; i < kFlatSize; ++i) {
+            if (_used[i]) {
+                func(i, _flat[i]);
+            }
+        }
+        for (auto &pr : _others) {
+            func(pr.first, pr.second);
+        }
+    }
+
+private:
+    bool _used[kFlatSize] = { false };
+    Stamp _flat[kFlatSize];
+    std::unordered_map<int, Stamp> _others;
+};
+
 //dts生成器，
 //pts排序后就是dts
 class DtsGenerator{
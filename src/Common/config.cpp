@@ -82,6 +82,9 @@ const string kEnableFFmpegLog = GENERAL_FIELD "enable_ffmpeg_log";
 const string kWaitTrackReadyMS = GENERAL_FIELD "wait_track_ready_ms";
 const string kWaitAddTrackMS = GENERAL_FIELD "wait_add_track_ms";
 const string kUnreadyFrameCache = GENERAL_FIELD "unready_frame_cache";
+const string kPlayerQueueMaxKB = GENERAL_FIELD "player_queue_max_kb";
+const string kPlayerQueueMaxMS = GENERAL_FIELD "player_queue_max_ms";
+const string kPlayerQueuePolicy = GENERAL_FIELD "player_queue_policy";
 
 static onceToken token([]() {
     mINI::Instance()[kFlowThreshold] = 1024;
@@ -96,6 +99,9 @@ static onceToken token([]() {
     mINI::Instance()[kWaitTrackReadyMS] = 10000;
     mINI::Instance()[kWaitAddTrackMS] = 3000;
     mINI::Instance()[kUnreadyFrameCache] = 100;
+    mINI::Instance()[kPlayerQueueMaxKB] = 8 * 1024;
+    mINI::Instance()[kPlayerQueueMaxMS] = 5000;
+    mINI::Instance()[kPlayerQueuePolicy] = 0;
 });
 
 } // namespace General
@@ -128,6 +134,7 @@ const string kRtspDemand = PROTOCOL_FIELD "rtsp_demand";
 const string kRtmpDemand = PROTOCOL_FIELD "rtmp_demand";
 const string kTSDemand = PROTOCOL_FIELD "ts_demand";
 const string kFMP4Demand = PROTOCOL_FIELD "fmp4_demand";
+const string kWarmIdle = PROTOCOL_FIELD "warm_idle";
 
 static onceToken token([]() {
     mINI::Instance()[kModifyStamp] = (int)ProtocolOption::kModifyStampRelative;
@@ -156,6 +163,7 @@ static onceToken token([]() {
     mINI::Instance()[kRtmpDemand] = 0;
     mINI::Instance()[kTSDemand] = 0;
     mINI::Instance()[kFMP4Demand] = 0;
+    mINI::Instance()[kWarmIdle] = 0;
 });
 } // !Protocol
 
@@ -174,6 +182,8 @@ const string kForbidCacheSuffix = HTTP_FIELD "forbidCacheSuffix";
 const string kForwardedIpHeader = HTTP_FIELD "forwarded_ip_header";
 const string kAllowCrossDomains = HTTP_FIELD "allow_cross_domains";
 const string kAllowIPRange = HTTP_FIELD "allow_ip_range";
+const string kSendFile = HTTP_FIELD "sendfile";
+const string kMmapCacheSizeMB = HTTP_FIELD "mmapCacheSizeMB";
 
 static onceToken token([]() {
     mINI::Instance()[kSendBufSize] = 64 * 1024;
@@ -198,6 +208,8 @@ static onceToken token([]() {
     mINI::Instance()[kForwardedIpHeader] = "";
     mINI::Instance()[kAllowCrossDomains] = 1;
     mINI::Instance()[kAllowIPRange] = "::1,127.0.0.1,172.16.0.0-172.31.255.255,192.168.0.0-192.168.255.255,10.0.0.0-10.255.255.255";
+    mINI::Instance()[kSendFile] = 0;
+    mINI::Instance()[kMmapCacheSizeMB] = 256;
 });
 
 } // namespace Http
@@ -219,6 +231,7 @@ const string kKeepAliveSecond = RTSP_FIELD "keepAliveSecond";
 const string kDirectProxy = RTSP_FIELD "directProxy";
 const string kLowLatency = RTSP_FIELD"lowLatency";
 const string kRtpTransportType = RTSP_FIELD"rtpTransportType";
+const string kUdpSharedPort = RTSP_FIELD "udpSharedPort";
 
 static onceToken token([]() {
     // 默认Md5方式认证
@@ -228,6 +241,7 @@ static onceToken token([]() {
     mINI::Instance()[kDirectProxy] = 1;
     mINI::Instance()[kLowLatency] = 0;
     mINI::Instance()[kRtpTransportType] = -1;
+    mINI::Instance()[kUdpSharedPort] = 0;
 });
 } // namespace Rtsp
 
@@ -257,6 +271,7 @@ const string kAudioMtuSize = RTP_FIELD "audioMtuSize";
 const string kRtpMaxSize = RTP_FIELD "rtpMaxSize";
 const string kLowLatency = RTP_FIELD "lowLatency";
 const string kH264StapA = RTP_FIELD "h264_stap_a";
+const string kAdaptiveJitter = RTP_FIELD "adaptiveJitter";
 
 static onceToken token([]() {
     mINI::Instance()[kVideoMtuSize] = 1400;
@@ -264,6 +279,7 @@ static onceToken token([]() {
     mINI::Instance()[kRtpMaxSize] = 10;
     mINI::Instance()[kLowLatency] = 0;
     mINI::Instance()[kH264StapA] = 1;
+    mINI::Instance()[kAdaptiveJitter] = 0;
 });
 } // namespace Rtp
 
@@ -276,11 +292,17 @@ const string kAddrMin = MULTI_FIELD "addrMin";
 const string kAddrMax = MULTI_FIELD "addrMax";
 // 组播TTL
 const string kUdpTTL = MULTI_FIELD "udpTTL";
+// 组播发送限速
+const string kPacingKbps = MULTI_FIELD "pacingKbps";
+// 组播发送最大突发
+const string kPacingBurstKB = MULTI_FIELD "pacingBurstKB";
 
 static onceToken token([]() {
     mINI::Instance()[kAddrMin] = "239.0.0.0";
     mINI::Instance()[kAddrMax] = "239.255.255.255";
     mINI::Instance()[kUdpTTL] = 64;
+    mINI::Instance()[kPacingKbps] = 0;
+    mINI::Instance()[kPacingBurstKB] = 64;
 });
 } // namespace MultiCast
 
@@ -316,6 +338,7 @@ const string kFileBufSize = HLS_FIELD "fileBufSize";
 const string kBroadcastRecordTs = HLS_FIELD "broadcastRecordTs";
 const string kDeleteDelaySec = HLS_FIELD "deleteDelaySec";
 const string kFastRegister = HLS_FIELD "fastRegister";
+const string kMemoryStore = HLS_FIELD "memoryStore";
 
 static onceToken token([]() {
     mINI::Instance()[kSegmentDuration] = 2;
@@ -327,6 +350,7 @@ static onceToken token([]() {
     mINI::Instance()[kBroadcastRecordTs] = false;
     mINI::Instance()[kDeleteDelaySec] = 10;
     mINI::Instance()[kFastRegister] = false;
+    mINI::Instance()[kMemoryStore] = false;
 });
 } // namespace Hls
 
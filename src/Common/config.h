@@ -196,6 +196,14 @@ extern const std::string kWaitTrackReadyMS;
 extern const std::string kWaitAddTrackMS;
 // 如果track未就绪，我们先缓存帧数据，但是有最大个数限制(100帧时大约4秒)，防止内存溢出
 extern const std::string kUnreadyFrameCache;
+// 播放器发送队列上限(单位KB)，socket发送缓存满后堆积的数据超过该值时触发背压策略，置0则不限制
+extern const std::string kPlayerQueueMaxKB;
+// 播放器发送队列最大堆积时长(单位毫秒)，超过该值时触发背压策略，置0则不限制
+extern const std::string kPlayerQueueMaxMS;
+// 播放器发送队列超过上限时的背压策略，0:只统计，1:丢弃至下一个关键帧，
+// 2:丢弃所有视频(保留音频)至下一个关键帧，3:断开播放器
+// 以上背压配置为全局配置，对所有tcp播放器生效，不支持按播放器单独配置，rtsp over udp播放不做背压检查
+extern const std::string kPlayerQueuePolicy;
 } // namespace General
 
 namespace Protocol {
@@ -246,6 +254,10 @@ extern const std::string kRtspDemand;
 extern const std::string kRtmpDemand;
 extern const std::string kTSDemand;
 extern const std::string kFMP4Demand;
+
+// 是否开启warm-idle模式，开启后rtsp/rtmp/ts/fmp4协议无人观看时不再打包，只保留配置帧与最近一个关键帧，
+// 有播放器时立即从该关键帧恢复打包(首帧秒开，但直到下一个关键帧前画面不会更新)
+extern const std::string kWarmIdle;
 } // !Protocol
 
 ////////////HTTP配置///////////
@@ -274,6 +286,10 @@ extern const std::string kForwardedIpHeader;
 extern const std::string kAllowCrossDomains;
 // 允许访问http api和http文件索引的ip地址范围白名单，置空情况下不做限制
 extern const std::string kAllowIPRange;
+// http(非https、非websocket)文件下载是否使用sendfile零拷贝发送，仅linux有效
+extern const std::string kSendFile;
+// mmap文件缓存常驻上限(MB)，超出后按lru淘汰，单个文件超过该值的1/16时不常驻，0为不常驻(仅同时访问时共享)
+extern const std::string kMmapCacheSizeMB;
 } // namespace Http
 
 ////////////SHELL配置///////////
@@ -304,6 +320,11 @@ extern const std::string kLowLatency;
 //当客户端发起RTSP SETUP的时候如果传输类型和此配置不一致则返回461 Unsupport Transport
 //迫使客户端重新SETUP并切换到对应协议。目前支持FFMPEG和VLC
 extern const std::string kRtpTransportType;
+
+// rtp over udp共享端口，默认0(关闭，每个track分配一对rtp/rtcp端口)
+// 开启后rtsp推流与播放的udp传输都使用该端口(rtp)与该端口+1(rtcp)，
+// 每个poller线程绑定一对SO_REUSEPORT socket，根据对端ip端口以及ssrc区分track
+extern const std::string kUdpSharedPort;
 } // namespace Rtsp
 
 ////////////RTMP服务器配置///////////
@@ -330,6 +351,8 @@ extern const std::string kRtpMaxSize;
 extern const std::string kLowLatency;
 //H264 rtp打包模式是否采用stap-a模式(为了在老版本浏览器上兼容webrtc)还是采用Single NAL unit packet per H.264 模式
 extern const std::string kH264StapA;
+// rtsp/国标收流时rtp排序窗口是否根据实测乱序深度与网络抖动自适应调整
+extern const std::string kAdaptiveJitter;
 } // namespace Rtp
 
 ////////////组播配置///////////
@@ -340,6 +363,11 @@ extern const std::string kAddrMin;
 extern const std::string kAddrMax;
 // 组播TTL
 extern const std::string kUdpTTL;
+// 每个组播组的发送速率上限，单位kbps，0为不限速
+// 限速后关键帧等突发数据会被平滑发送，防止交换机缓存溢出
+extern const std::string kPacingKbps;
+// 限速时允许的最大突发数据量，单位KB
+extern const std::string kPacingBurstKB;
 } // namespace MultiCast
 
 ////////////录像配置///////////
@@ -378,6 +406,8 @@ extern const std::string kBroadcastRecordTs;
 extern const std::string kDeleteDelaySec;
 // 如果设置为1，则第一个切片长度强制设置为1个GOP
 extern const std::string kFastRegister;
+// hls直播切片与m3u8是否只保存在内存中，由http服务器直接从内存回复，不写磁盘(segKeep开启时异步落盘)
+extern const std::string kMemoryStore;
 } // namespace Hls
 
 ////////////Rtp代理相关配置///////////
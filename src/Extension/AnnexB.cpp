@@ -0,0 +1,74 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstdint>
+#include "AnnexB.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANNEXB_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace mediakit {
+
+#if defined(ANNEXB_USE_SSE2)
+static inline int countTrailingZero(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return (int)index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif
+
+const char *findStartCode(const char *ptr, const char *end) {
+    auto p = (const uint8_t *)ptr;
+    auto e = (const uint8_t *)end;
+
+#if defined(ANNEXB_USE_SSE2)
+    // 每次比较16个位置: p[i] == 0 && p[i + 1] == 0 && p[i + 2] == 1
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    while (e - p >= 18) {
+        auto b0 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)p), zero);
+        auto b1 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + 1)), zero);
+        auto b2 = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + 2)), one);
+        auto mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(b0, b1), b2));
+        if (mask) {
+            return (const char *)(p + countTrailingZero(mask));
+        }
+        p += 16;
+    }
+#endif
+
+    // 标量实现，q指向起始码的第三个字节，根据其值尽量跳跃
+    for (auto q = p + 2; q < e;) {
+        if (*q > 1) {
+            // q不可能属于以q、q+1、q+2结尾的起始码
+            q += 3;
+        } else if (q[-1]) {
+            // q-1不为0，起始码不可能以q、q+1结尾
+            q += 2;
+        } else if (q[-2] || *q != 1) {
+            ++q;
+        } else {
+            return (const char *)(q - 2);
+        }
+    }
+    return nullptr;
+}
+
+} // namespace mediakit
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_ANNEXB_H
+#define ZLMEDIAKIT_ANNEXB_H
+
+#include <cstddef>
+
+namespace mediakit {
+
+/**
+ * 查找Annex-B起始码(00 00 01)，H264/H265/SVAC拆分nalu以及PS解析共用
+ * x86平台采用SSE2实现(x86_64默认开启)，其他平台采用跳跃式的标量实现
+ * @param ptr 开始查找的位置
+ * @param end 查找的结束位置(不包含)，起始码的3个字节必须都在[ptr, end)内
+ * @return 起始码(00 00 01)第一个字节的位置，未找到返回nullptr
+ */
+const char *findStartCode(const char *ptr, const char *end);
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_ANNEXB_H
@@ -35,7 +35,7 @@ Frame::Ptr Frame::getCacheAbleFrame(const Frame::Ptr &frame){
     if(frame->cacheAble()){
         return frame;
     }
-    return std::make_shared<FrameCacheAble>(frame);
+    return makeFrame<FrameCacheAble>(frame);
 }
 
 FrameStamp::FrameStamp(Frame::Ptr frame, Stamp &stamp, int modify_stamp)
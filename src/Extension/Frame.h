@@ -13,6 +13,8 @@
 
 #include <map>
 #include <mutex>
+#include <atomic>
+#include <cstddef>
 #include <functional>
 #include "Util/List.h"
 #include "Util/TimeTicker.h"
@@ -212,6 +214,193 @@ private:
     toolkit::ObjectStatistic<Frame> _statistic;
 };
 
+/**
+ * 帧对象内存池，按内存块大小分别维护线程局部的空闲链表
+ * 帧对象一般在poller线程中创建并释放，线程局部免去了加锁；
+ * 跨线程释放时内存块无锁归还到分配线程，由分配线程下次分配时取回，这样生产者/消费者线程对也能复用内存
+ */
+template <size_t kSize>
+class FrameMemoryPool {
+public:
+    // 每个线程每种大小最多缓存的空闲内存块个数(不含其他线程归还的内存块)
+    static constexpr size_t kMaxFreeCount = 1024;
+
+    static void *allocate() {
+        auto owner = localOwner();
+        if (!owner) {
+            // 本线程的内存池已销毁(线程退出中)，直接分配
+            return initBlock(::operator new(kBlockSize), nullptr);
+        }
+        if (!owner->head) {
+            owner->takeRemote();
+        }
+        void *block = owner->head;
+        if (block) {
+            owner->head = owner->head->next;
+            --owner->size;
+        } else {
+            block = ::operator new(kBlockSize);
+        }
+        // 每个未释放的内存块持有一个分配线程的引用，保证跨线程释放时归还目标有效
+        owner->refs.fetch_add(1, std::memory_order_relaxed);
+        return initBlock(block, owner);
+    }
+
+    static void deallocate(void *ptr) {
+        auto block = static_cast<char *>(ptr) - kHeaderSize;
+        auto owner = *reinterpret_cast<Owner **>(block);
+        if (!owner) {
+            ::operator delete(block);
+            return;
+        }
+        if (owner == currentOwner()) {
+            if (owner->size < kMaxFreeCount) {
+                auto node = reinterpret_cast<Node *>(block);
+                node->next = owner->head;
+                owner->head = node;
+                ++owner->size;
+            } else {
+                ::operator delete(block);
+            }
+        } else {
+            // 其他线程(或分配线程已退出)，归还到分配线程
+            owner->pushRemote(reinterpret_cast<Node *>(block));
+        }
+        owner->release();
+    }
+
+private:
+    // 内存块头部保存分配线程，对象紧随其后并保持对齐
+    static constexpr size_t kHeaderSize = alignof(std::max_align_t) > sizeof(void *) ? alignof(std::max_align_t) : sizeof(void *);
+    static constexpr size_t kBlockSize = kHeaderSize + kSize;
+
+    struct Node {
+        Node *next;
+    };
+
+    struct Owner {
+        // 以下两个成员只在分配线程访问
+        Node *head = nullptr;
+        size_t size = 0;
+        // 其他线程归还的内存块
+        std::atomic<Node *> remote { nullptr };
+        // 分配线程本身持有一个引用
+        std::atomic<size_t> refs { 1 };
+
+        void takeRemote() {
+            head = remote.exchange(nullptr, std::memory_order_acquire);
+            size = 0;
+            for (auto node = head; node; node = node->next) {
+                ++size;
+            }
+        }
+
+        void pushRemote(Node *node) {
+            node->next = remote.load(std::memory_order_relaxed);
+            while (!remote.compare_exchange_weak(node->next, node, std::memory_order_release, std::memory_order_relaxed)) {}
+        }
+
+        void release() {
+            if (refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+            // 分配线程已退出且所有内存块都已归还
+            takeRemote();
+            freeLocal();
+            delete this;
+        }
+
+        void freeLocal() {
+            while (head) {
+                auto next = head->next;
+                ::operator delete(head);
+                head = next;
+            }
+            size = 0;
+        }
+    };
+
+    struct OwnerHolder {
+        Owner *owner;
+        ~OwnerHolder() {
+            // 此后本线程释放的内存块按跨线程归还处理，分配时不再使用内存池
+            currentOwner() = nullptr;
+            destroyed() = true;
+            owner->freeLocal();
+            owner->release();
+        }
+    };
+
+    static void *initBlock(void *block, Owner *owner) {
+        *static_cast<Owner **>(block) = owner;
+        return static_cast<char *>(block) + kHeaderSize;
+    }
+
+    // 以下两个线程局部变量均可平凡析构，线程退出过程中仍可安全访问
+    static Owner *&currentOwner() {
+        static thread_local Owner *s_owner = nullptr;
+        return s_owner;
+    }
+
+    static bool &destroyed() {
+        static thread_local bool s_destroyed = false;
+        return s_destroyed;
+    }
+
+    static Owner *localOwner() {
+        auto &owner = currentOwner();
+        if (!owner && !destroyed()) {
+            owner = new Owner;
+            // 线程退出时释放空闲链表并归还分配线程的引用
+            static thread_local OwnerHolder s_holder { owner };
+        }
+        return owner;
+    }
+};
+
+/**
+ * 供std::allocate_shared使用的帧对象分配器，帧对象与shared_ptr控制块一次分配并从FrameMemoryPool复用
+ */
+template <typename T>
+class FrameAllocator {
+public:
+    using value_type = T;
+
+    FrameAllocator() = default;
+    template <typename U>
+    FrameAllocator(const FrameAllocator<U> &) {}
+
+    T *allocate(size_t n) {
+        if (n != 1) {
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        }
+        return static_cast<T *>(FrameMemoryPool<sizeof(T)>::allocate());
+    }
+
+    void deallocate(T *ptr, size_t n) {
+        if (n != 1) {
+            ::operator delete(ptr);
+            return;
+        }
+        FrameMemoryPool<sizeof(T)>::deallocate(ptr);
+    }
+
+    template <typename U>
+    bool operator==(const FrameAllocator<U> &) const { return true; }
+    template <typename U>
+    bool operator!=(const FrameAllocator<U> &) const { return false; }
+};
+
+/**
+ * 创建帧对象(用于替代std::make_shared)，帧对象在转协议流水线中每帧每跳都会创建，
+ * 采用线程局部内存池避免频繁malloc/free
+ * 目前只用于test_bench_frame_alloc所测量的热点路径: FrameFromPtr、FrameStamp与FrameCacheAble
+ */
+template <typename T, typename... ARGS>
+std::shared_ptr<T> makeFrame(ARGS &&...args) {
+    return std::allocate_shared<T>(FrameAllocator<T>(), std::forward<ARGS>(args)...);
+}
+
 class FrameImp : public Frame {
 public:
     using Ptr = std::shared_ptr<FrameImp>;
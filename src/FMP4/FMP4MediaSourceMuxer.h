@@ -23,6 +23,7 @@ public:
 
     FMP4MediaSourceMuxer(const MediaTuple& tuple, const ProtocolOption &option) {
         _option = option;
+        _warm_idle.enable(option.warm_idle);
         _media_src = std::make_shared<FMP4MediaSource>(tuple);
     }
 
@@ -46,6 +47,9 @@ public:
     }
 
     bool inputFrame(const Frame::Ptr &frame) override {
+        if (_warm_idle.enabled()) {
+            return _warm_idle.inputFrame(_media_src, frame, [this](const Frame::Ptr &frame) { return MP4MuxerMemory::inputFrame(frame); });
+        }
         if (_clear_cache && _option.fmp4_demand) {
             _clear_cache = false;
             _media_src->clearCache();
@@ -57,6 +61,10 @@ public:
     }
 
     bool isEnabled() {
+        if (_warm_idle.enabled()) {
+            //warm-idle模式需要一直输入帧以便维护关键帧缓存(无人观看时由WarmIdleHelper停止打包)，按需转协议开关无效
+            return true;
+        }
         //缓存尚未清空时，还允许触发inputFrame函数，以便及时清空缓存
         return _option.fmp4_demand ? (_clear_cache ? true : _enabled) : true;
     }
@@ -80,6 +88,7 @@ private:
     bool _enabled = true;
     bool _clear_cache = false;
     ProtocolOption _option;
+    WarmIdleHelper _warm_idle;
     FMP4MediaSource::Ptr _media_src;
 };
 
@@ -9,7 +9,10 @@
  */
 
 #include <csignal>
-#include <tuple>
+#include <list>
+#include <vector>
+#include <unordered_map>
+#include <sys/stat.h>
 
 #ifndef _WIN32
 #include <sys/mman.h>
@@ -26,6 +29,7 @@
 
 #include "HttpBody.h"
 #include "HttpClient.h"
+#include "Common/config.h"
 #include "Common/macros.h"
 
 using namespace std;
@@ -53,8 +57,61 @@ Buffer::Ptr HttpStringBody::readData(size_t size) {
 }
 
 //////////////////////////////////////////////////////////////////
-static mutex s_mtx;
-static unordered_map<string /*file_path*/, std::tuple<char */*ptr*/, int64_t /*size*/, weak_ptr<char> /*mmap*/ > > s_shared_mmap;
+// 共享mmap缓存，按文件路径哈希分片，各分片独立加锁，并按字节数上限做lru淘汰
+// 被淘汰的mmap在仍被HttpFileBody引用时不会立即释放，只是不再被后续请求共享
+static constexpr size_t kMmapShardCount = 16;
+
+struct MmapCacheItem {
+    char *ptr = nullptr;
+    int64_t size = 0;
+    MmapFileInfo info;
+    weak_ptr<char> mmap;
+    // lru缓存持有的强引用，文件过大时为空(不常驻内存)
+    shared_ptr<char> hold;
+    list<string>::iterator lru;
+};
+
+struct MmapCacheShard {
+    mutex mtx;
+    // 最近访问的在前
+    list<string> lru;
+    unordered_map<string /*file_path*/, MmapCacheItem> items;
+    int64_t hold_bytes = 0;
+};
+
+static MmapCacheStatistic s_mmap_statistic;
+
+const MmapCacheStatistic &getMmapCacheStatistic() {
+    return s_mmap_statistic;
+}
+
+static MmapCacheShard &getMmapShard(const string &file_path) {
+    // 不析构，防止程序退出时释放常驻的mmap触发delSharedMmap访问已析构的缓存
+    static auto s_mmap_shard = new MmapCacheShard[kMmapShardCount];
+    return s_mmap_shard[hash<string>()(file_path) % kMmapShardCount];
+}
+
+static void toFileInfo(const struct stat &st, MmapFileInfo &info) {
+    info.inode = st.st_ino;
+    info.size = st.st_size;
+#if defined(__linux__) || defined(__linux)
+    info.mtime_ns = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#else
+    info.mtime_ns = st.st_mtime * 1000000000LL;
+#endif
+}
+
+// 删除缓存记录，其持有的mmap强引用转移到released，需在解锁后释放(释放时会触发delSharedMmap加锁)
+static void eraseMmapItem(MmapCacheShard &shard, unordered_map<string, MmapCacheItem>::iterator it, vector<shared_ptr<char> > &released) {
+    auto &item = it->second;
+    if (item.hold) {
+        shard.hold_bytes -= item.size;
+        s_mmap_statistic.bytes -= item.size;
+        released.emplace_back(std::move(item.hold));
+    }
+    shard.lru.erase(item.lru);
+    shard.items.erase(it);
+}
 
 #if defined(_WIN32)
 static void mmap_close(HANDLE _hfile, HANDLE _hmapping, void *_addr) {
@@ -74,26 +131,82 @@ static void mmap_close(HANDLE _hfile, HANDLE _hmapping, void *_addr) {
 
 //删除mmap记录
 static void delSharedMmap(const string &file_path, char *ptr) {
-    lock_guard<mutex> lck(s_mtx);
-    auto it = s_shared_mmap.find(file_path);
-    if (it != s_shared_mmap.end() && std::get<0>(it->second) == ptr) {
-        s_shared_mmap.erase(it);
+    vector<shared_ptr<char> > released;
+    auto &shard = getMmapShard(file_path);
+    lock_guard<mutex> lck(shard.mtx);
+    auto it = shard.items.find(file_path);
+    if (it != shard.items.end() && it->second.ptr == ptr) {
+        eraseMmapItem(shard, it, released);
+    }
+}
+
+static void addSharedMmap(const string &file_path, const std::shared_ptr<char> &mmap, int64_t file_size, const MmapFileInfo &info) {
+    GET_CONFIG(uint32_t, cache_size_mb, Http::kMmapCacheSizeMB);
+    int64_t shard_bytes = (int64_t)cache_size_mb * 1024 * 1024 / kMmapShardCount;
+
+    vector<shared_ptr<char> > released;
+    auto &shard = getMmapShard(file_path);
+    lock_guard<mutex> lck(shard.mtx);
+    auto it = shard.items.find(file_path);
+    if (it != shard.items.end()) {
+        //其他线程同时映射了该文件，替换之
+        eraseMmapItem(shard, it, released);
+    }
+    shard.lru.emplace_front(file_path);
+    auto &item = shard.items[file_path];
+    item.ptr = mmap.get();
+    item.size = file_size;
+    item.info = info;
+    item.mmap = mmap;
+    item.lru = shard.lru.begin();
+    if (file_size > shard_bytes) {
+        //文件过大或关闭了缓存，只在同时访问时共享，不常驻
+        return;
+    }
+    item.hold = mmap;
+    shard.hold_bytes += file_size;
+    s_mmap_statistic.bytes += file_size;
+    while (shard.hold_bytes > shard_bytes) {
+        //淘汰最久未访问的文件
+        auto victim = shard.items.find(shard.lru.back());
+        if (victim->second.hold) {
+            ++s_mmap_statistic.evictions;
+        }
+        eraseMmapItem(shard, victim, released);
     }
 }
 
-static std::shared_ptr<char> getSharedMmap(const string &file_path, int64_t &file_size) {
+static std::shared_ptr<char> getSharedMmap(const string &file_path, int64_t &file_size, MmapFileInfo &info) {
+    struct stat st;
+    if (stat(file_path.data(), &st) != 0) {
+        //文件不存在
+        file_size = -1;
+        return nullptr;
+    }
+    toFileInfo(st, info);
     {
-        lock_guard<mutex> lck(s_mtx);
-        auto it = s_shared_mmap.find(file_path);
-        if (it != s_shared_mmap.end()) {
-            auto ret = std::get<2>(it->second).lock();
-            if (ret) {
-                //命中mmap缓存
-                file_size = std::get<1>(it->second);
-                return ret;
+        vector<shared_ptr<char> > released;
+        auto &shard = getMmapShard(file_path);
+        lock_guard<mutex> lck(shard.mtx);
+        auto it = shard.items.find(file_path);
+        if (it != shard.items.end()) {
+            if (it->second.info == info) {
+                auto ret = it->second.mmap.lock();
+                if (ret) {
+                    //命中mmap缓存
+                    ++s_mmap_statistic.hits;
+                    shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lru);
+                    file_size = it->second.size;
+                    return ret;
+                }
+            } else {
+                //文件被改写(例如hls切片被覆盖)，缓存失效
+                ++s_mmap_statistic.invalidations;
             }
+            eraseMmapItem(shard, it, released);
         }
     }
+    ++s_mmap_statistic.misses;
 
     //打开文件
     std::shared_ptr<FILE> fp(fopen(file_path.data(), "rb"), [](FILE *fp) {
@@ -121,6 +234,10 @@ static std::shared_ptr<char> getSharedMmap(const string &file_path, int64_t &fil
         return nullptr;
     }
 #ifndef _WIN32
+    if (fstat(fd, &st) == 0) {
+        //以实际映射的文件为准
+        toFileInfo(st, info);
+    }
     auto ptr = (char *)mmap(NULL, file_size, PROT_READ, MAP_SHARED, fd, 0);
     if (ptr == MAP_FAILED) {
         WarnL << "mmap " << file_path << " failed:" << get_uv_errmsg(false);
@@ -128,7 +245,9 @@ static std::shared_ptr<char> getSharedMmap(const string &file_path, int64_t &fil
     }
 
 
-    std::shared_ptr<char> ret(ptr, [file_size, fp, file_path](char *ptr) {
+    //映射建立后不再需要文件fd，立即关闭，防止常驻缓存的文件占用大量fd
+    fp.reset();
+    std::shared_ptr<char> ret(ptr, [file_size, file_path](char *ptr) {
         munmap(ptr, file_size);
         delSharedMmap(file_path, ptr);
     });
@@ -159,8 +278,10 @@ static std::shared_ptr<char> getSharedMmap(const string &file_path, int64_t &fil
         return nullptr;
     }
 
-    std::shared_ptr<char> ret((char *)(addr_), [hfile, hmapping, file_path](char *addr_) {
-        mmap_close(hfile, hmapping, addr_);
+    //映射建立后不再需要文件与映射句柄，立即关闭
+    mmap_close(hfile, hmapping, nullptr);
+    std::shared_ptr<char> ret((char *)(addr_), [file_path](char *addr_) {
+        mmap_close(INVALID_HANDLE_VALUE, NULL, addr_);
         delSharedMmap(file_path, addr_);
     });
 
@@ -177,16 +298,14 @@ static std::shared_ptr<char> getSharedMmap(const string &file_path, int64_t &fil
         });
     }
 #endif
-    {
-        lock_guard<mutex> lck(s_mtx);
-        s_shared_mmap[file_path] = std::make_tuple(ret.get(), file_size, ret);
-    }
+    addSharedMmap(file_path, ret, file_size, info);
     return ret;
 }
 
 HttpFileBody::HttpFileBody(const string &file_path, bool use_mmap) {
+    _file_path = file_path;
     if (use_mmap ) {
-        _map_addr = getSharedMmap(file_path, _read_to);       
+        _map_addr = getSharedMmap(file_path, _read_to, _map_info);
     }
 
     if (!_map_addr && _read_to != -1) {
@@ -218,14 +337,51 @@ void HttpFileBody::setRange(uint64_t offset, uint64_t max_size) {
     }
 }
 
-int HttpFileBody::sendFile(int fd) {
+ssize_t HttpFileBody::sendFile(int fd, size_t size) {
 #if defined(__linux__) || defined(__linux)
     if (!_fp) {
-        return -1;
+        // mmap模式，sendfile需要文件fd
+        _fp.reset(fopen(_file_path.data(), "rb"), [](FILE *fp) {
+            if (fp) {
+                fclose(fp);
+            }
+        });
+        if (!_fp) {
+            return -1;
+        }
+        struct stat st;
+        MmapFileInfo info;
+        if (fstat(fileno(_fp.get()), &st) == 0) {
+            toFileInfo(st, info);
+        }
+        if (!(info == _map_info)) {
+            // 映射后文件被替换或改写(例如hls切片被覆盖)，不能sendfile，回退到从映射内存读取，防止混入另一文件的数据
+            WarnL << "file changed after mmap, disable sendfile:" << _file_path;
+            _fp.reset();
+            return -1;
+        }
     }
     static onceToken s_token([]() { signal(SIGPIPE, SIG_IGN); });
     off_t off = _file_offset;
-    return sendfile(fd, fileno(_fp.get()), &off, _read_to - _file_offset);
+    ssize_t ret;
+    do {
+        ret = sendfile(fd, fileno(_fp.get()), &off, MIN((int64_t)size, _read_to - _file_offset));
+    } while (-1 == ret && UV_EINTR == get_uv_error(true));
+
+    if (ret > 0) {
+        _file_offset += ret;
+        if (!_map_addr) {
+            // sendfile不改变文件读取位置，fread模式下需要同步，以便回退到readData
+            fseek64(_fp.get(), _file_offset, SEEK_SET);
+        }
+        return ret;
+    }
+    if (ret == 0) {
+        // 文件真实长度小于声明长度
+        WarnL << "sendfile reached eof:" << _file_path;
+        return -1;
+    }
+    return UV_EAGAIN == get_uv_error(true) ? 0 : -1;
 #else
     return -1;
 #endif
@@ -12,6 +12,7 @@
 #define ZLMEDIAKIT_FILEREADER_H
 
 #include <stdlib.h>
+#include <atomic>
 #include <memory>
 #include "Network/Buffer.h"
 #include "Util/ResourcePool.h"
@@ -57,11 +58,12 @@ public:
     }
 
     /**
-     * 使用sendfile优化文件发送
-     * @param fd socket fd
-     * @return 0成功，其他为错误代码
+     * 使用sendfile零拷贝发送文件
+     * @param fd 非阻塞socket fd
+     * @param size 本次最多发送字节数
+     * @return 大于0为本次发送字节数，0为socket发送缓存已满，小于0为不支持或发送失败
      */
-    virtual int sendFile(int fd) {
+    virtual ssize_t sendFile(int fd, size_t size) {
         return -1;
     }
 };
@@ -97,6 +99,19 @@ private:
     toolkit::Buffer::Ptr _buffer;
 };
 
+/**
+ * mmap映射文件的标识，用于判断文件是否被改写或替换
+ */
+struct MmapFileInfo {
+    uint64_t inode = 0;
+    int64_t size = 0;
+    int64_t mtime_ns = 0;
+
+    bool operator==(const MmapFileInfo &that) const {
+        return inode == that.inode && size == that.size && mtime_ns == that.mtime_ns;
+    }
+};
+
 /**
  * 文件类型的content
  */
@@ -120,16 +135,36 @@ public:
 
     int64_t remainSize() override;
     toolkit::Buffer::Ptr readData(size_t size) override;
-    int sendFile(int fd) override;
+    ssize_t sendFile(int fd, size_t size) override;
 
 private:
     int64_t _read_to = 0;
     uint64_t _file_offset = 0;
     std::shared_ptr<FILE> _fp;
     std::shared_ptr<char> _map_addr;
+    // mmap映射的文件标识，sendfile重新打开文件时校验是否为同一文件
+    MmapFileInfo _map_info;
+    // mmap模式下sendfile时再打开文件
+    std::string _file_path;
     toolkit::ResourcePool<toolkit::BufferRaw> _pool;
 };
 
+/**
+ * 共享mmap文件缓存统计，可以跨线程读取
+ */
+struct MmapCacheStatistic {
+    std::atomic<uint64_t> hits { 0 };
+    std::atomic<uint64_t> misses { 0 };
+    // 文件被改写(inode、大小或修改时间变化)导致的缓存失效次数
+    std::atomic<uint64_t> invalidations { 0 };
+    // 超出缓存上限被淘汰的次数
+    std::atomic<uint64_t> evictions { 0 };
+    // 缓存常驻的mmap字节数
+    std::atomic<int64_t> bytes { 0 };
+};
+
+const MmapCacheStatistic &getMmapCacheStatistic();
+
 class HttpArgs;
 
 /**
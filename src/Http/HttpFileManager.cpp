@@ -457,7 +457,7 @@ static string pathCat(const string &a, const string &b){
  */
 static void accessFile(Session &sender, const Parser &parser, const MediaInfo &media_info, const string &file_path, const HttpFileManager::invoker &cb) {
     bool is_hls = end_with(file_path, kHlsSuffix) || end_with(file_path, kHlsFMP4Suffix);
-    if (!is_hls && !File::fileExist(file_path)) {
+    if (!is_hls && !File::fileExist(file_path) && !HlsMemoryStore::Instance().find(file_path)) {
         //文件不存在且不是hls,那么直接返回404
         sendNotFound(cb);
         return;
@@ -508,6 +508,13 @@ static void accessFile(Session &sender, const Parser &parser, const MediaInfo &m
             GET_CONFIG_FUNC(vector<string>, forbidCacheSuffix, Http::kForbidCacheSuffix, [](const string &str) {
                 return split(str, ",");
             });
+            if (file_content.empty()) {
+                // hls内存模式下，切片与m3u8直接从内存回复(不支持Range)
+                if (auto buffer = HlsMemoryStore::Instance().find(file_path)) {
+                    invoker(200, httpHeader, std::make_shared<HttpBufferBody>(std::move(buffer)));
+                    return;
+                }
+            }
             bool is_forbid_cache = false;
             for (auto &suffix : forbidCacheSuffix) {
                 if (suffix != "" && end_with(file_path, suffix)) {
@@ -32,7 +32,7 @@ public:
     /**
      * 恢复初始设置
      */
-    void reset();
+    virtual void reset();
 
     /**
      * 剩余数据大小
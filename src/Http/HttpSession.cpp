@@ -10,7 +10,11 @@
 
 #include <stdio.h>
 #include <sys/stat.h>
+#if defined(__linux__) || defined(__linux)
+#include <unistd.h>
+#endif
 #include <algorithm>
+#include <typeinfo>
 #include "Common/config.h"
 #include "Common/strCoding.h"
 #include "HttpSession.h"
@@ -361,6 +365,14 @@ bool HttpSession::checkLiveStreamFMP4(const function<void()> &cb) {
                 // 本对象已经销毁
                 return;
             }
+            auto action = strong_self->_back_pressure.check(*strong_self, fmp4_list, false);
+            if (action == BackPressure::kActionDisconnect) {
+                strong_self->shutdown(SockException(Err_shutdown, "fmp4 player send queue overflow"));
+                return;
+            }
+            if (action == BackPressure::kActionDrop) {
+                return;
+            }
             size_t i = 0;
             auto size = fmp4_list->size();
             fmp4_list->for_each([&](const FMP4Packet::Ptr &ts) { strong_self->onWrite(ts, ++i == size); });
@@ -405,6 +417,14 @@ bool HttpSession::checkLiveStreamTS(const function<void()> &cb) {
                 // 本对象已经销毁
                 return;
             }
+            auto action = strong_self->_back_pressure.check(*strong_self, ts_list, false);
+            if (action == BackPressure::kActionDisconnect) {
+                strong_self->shutdown(SockException(Err_shutdown, "ts player send queue overflow"));
+                return;
+            }
+            if (action == BackPressure::kActionDrop) {
+                return;
+            }
             size_t i = 0;
             auto size = ts_list->size();
             ts_list->for_each([&](const TSPacket::Ptr &ts) { strong_self->onWrite(ts, ++i == size); });
@@ -508,10 +528,32 @@ class AsyncSenderData {
 public:
     friend class AsyncSender;
     using Ptr = std::shared_ptr<AsyncSenderData>;
-    AsyncSenderData(HttpSession::Ptr session, const HttpBody::Ptr &body, bool close_when_complete) {
+    AsyncSenderData(HttpSession::Ptr session, const HttpBody::Ptr &body, bool close_when_complete, bool send_file = false) {
         _session = std::move(session);
         _body = body;
         _close_when_complete = close_when_complete;
+        _send_file = send_file;
+    }
+
+    ~AsyncSenderData() {
+        stopWatchWriteAble();
+    }
+
+private:
+    // sendfile遇到内核发送缓存满时，监听socket可写事件
+    // socket fd已由Socket注册到poller，所以监听其dup出来的fd(边沿触发)，sendfile发送期间一直保持监听
+    bool watchWriteAble(const std::shared_ptr<HttpSession> &session, const std::shared_ptr<AsyncSenderData> &self);
+
+    void stopWatchWriteAble() {
+#if defined(__linux__) || defined(__linux)
+        if (_write_able_fd == -1) {
+            return;
+        }
+        // 必须先从epoll移除再关闭，否则关闭dup出来的fd后epoll中的注册不会被移除
+        auto fd = _write_able_fd;
+        _write_able_fd = -1;
+        _poller->delEvent(fd, [fd](bool) { close(fd); });
+#endif
     }
 
 private:
@@ -519,10 +561,14 @@ private:
     HttpBody::Ptr _body;
     bool _close_when_complete;
     bool _read_complete = false;
+    bool _send_file;
+    int _write_able_fd = -1;
+    EventPoller::Ptr _poller;
 };
 
 class AsyncSender {
 public:
+    friend class AsyncSenderData;
     using Ptr = std::shared_ptr<AsyncSender>;
     static bool onSocketFlushed(const AsyncSenderData::Ptr &data) {
         if (data->_read_complete) {
@@ -533,6 +579,10 @@ public:
             return false;
         }
 
+        if (data->_send_file) {
+            return onSendFile(data);
+        }
+
         GET_CONFIG(uint32_t, sendBufSize, Http::kSendBufSize);
         data->_body->readDataAsync(sendBufSize, [data](const Buffer::Ptr &sendBuf) {
             auto session = data->_session.lock();
@@ -553,6 +603,62 @@ public:
     }
 
 private:
+    static bool onSendFile(const AsyncSenderData::Ptr &data) {
+        auto session = data->_session.lock();
+        if (!session) {
+            // 本对象已经销毁
+            return false;
+        }
+        if (data->_read_complete) {
+            return false;
+        }
+        if (session->isSocketBusy()) {
+            // http头或上次的数据还未写入内核，等待socket发送缓存清空，防止数据乱序
+            return true;
+        }
+        // socket发送缓存已清空，可以绕过socket发送缓存直接写fd
+        session->_ticker.resetTime();
+        auto fd = session->getSock()->rawFD();
+        GET_CONFIG(uint32_t, sendBufSize, Http::kSendBufSize);
+        // 每次最多发送的字节数，防止高速链路下长时间占用poller线程
+        size_t budget = (size_t)sendBufSize * kSendFileBudgetFactor;
+        while (data->_body->remainSize() > 0) {
+            if (!budget) {
+                // 本次发送额度用完，让出poller线程，稍后继续发送
+                std::weak_ptr<AsyncSenderData> weak_data = data;
+                session->async([weak_data]() {
+                    if (auto data = weak_data.lock()) {
+                        onSendFile(data);
+                    }
+                }, false);
+                return true;
+            }
+            auto sent = data->_body->sendFile(fd, budget);
+            if (sent > 0) {
+                budget -= MIN((size_t)sent, budget);
+                continue;
+            }
+            if (sent < 0 || !data->watchWriteAble(session, data)) {
+                // 不支持sendfile或发送失败，回退到普通发送方式
+                data->stopWatchWriteAble();
+                data->_send_file = false;
+                return onSocketFlushed(data);
+            }
+            // 内核发送缓存已满，等待socket可写事件
+            return true;
+        }
+        // 文件写完了
+        data->stopWatchWriteAble();
+        data->_read_complete = true;
+        if (data->_close_when_complete) {
+            shutdown(session);
+        }
+        return false;
+    }
+
+    // sendfile模式下每次可写事件最多发送sendBufSize的倍数
+    static constexpr size_t kSendFileBudgetFactor = 16;
+
     static void onRequestData(const AsyncSenderData::Ptr &data, const std::shared_ptr<HttpSession> &session, const Buffer::Ptr &sendBuf) {
         session->_ticker.resetTime();
         if (sendBuf && session->send(sendBuf) != -1) {
@@ -577,6 +683,33 @@ private:
     }
 };
 
+bool AsyncSenderData::watchWriteAble(const std::shared_ptr<HttpSession> &session, const std::shared_ptr<AsyncSenderData> &self) {
+#if defined(__linux__) || defined(__linux)
+    if (_write_able_fd != -1) {
+        // 已经在监听，边沿触发，socket再次可写时会收到事件
+        return true;
+    }
+    auto fd = dup(session->getSock()->rawFD());
+    if (fd == -1) {
+        return false;
+    }
+    std::weak_ptr<AsyncSenderData> weak_self = self;
+    _poller = session->getPoller();
+    if (-1 == _poller->addEvent(fd, EventPoller::Event_Write | EventPoller::Event_Error, [weak_self](int event) {
+        if (auto self = weak_self.lock()) {
+            AsyncSender::onSendFile(self);
+        }
+    })) {
+        close(fd);
+        return false;
+    }
+    _write_able_fd = fd;
+    return true;
+#else
+    return false;
+#endif
+}
+
 void HttpSession::sendResponse(int code,
                                bool bClose,
                                const char *pcContentType,
@@ -663,22 +796,21 @@ void HttpSession::sendResponse(int code,
         return;
     }
 
-#if 0
-    //sendfile跟共享mmap相比并没有性能上的优势，相反，sendfile还有功能上的缺陷，先屏蔽
-    if (typeid(*this) == typeid(HttpSession) && !body->sendFile(getSock()->rawFD())) {
-        // http支持sendfile优化
-        return;
-    }
-#endif
-
     GET_CONFIG(uint32_t, sendBufSize, Http::kSendBufSize);
     if (body->remainSize() > sendBufSize) {
         // 文件下载提升发送性能
         setSocketFlags();
     }
 
+    bool send_file = false;
+#if defined(__linux__) || defined(__linux)
+    GET_CONFIG(bool, enable_send_file, Http::kSendFile);
+    // https需要加密、websocket需要封装帧头，只有明文http才能sendfile零拷贝发送
+    send_file = enable_send_file && typeid(*this) == typeid(HttpSession) && !_live_over_websocket;
+#endif
+
     // 发送http body
-    AsyncSenderData::Ptr data = std::make_shared<AsyncSenderData>(static_pointer_cast<HttpSession>(shared_from_this()), body, bClose);
+    AsyncSenderData::Ptr data = std::make_shared<AsyncSenderData>(static_pointer_cast<HttpSession>(shared_from_this()), body, bClose, send_file);
     getSock()->setOnFlush([data]() { return AsyncSender::onSocketFlushed(data); });
     AsyncSender::onSocketFlushed(data);
 }
@@ -770,6 +902,23 @@ void HttpSession::onWrite(const Buffer::Ptr &buffer, bool flush) {
     }
 }
 
+void HttpSession::onWriteWebSocketFrame(const Buffer::Ptr &frame, bool flush) {
+    if (flush) {
+        // 需要flush那么一次刷新缓存
+        HttpSession::setSendFlushFlag(true);
+    }
+
+    _ticker.resetTime();
+    // 已经封装好websocket帧头，直接发送
+    _total_bytes_usage += frame->size();
+    send(frame);
+
+    if (flush) {
+        // 本次刷新缓存后，下次不用刷新缓存
+        HttpSession::setSendFlushFlag(false);
+    }
+}
+
 void HttpSession::onWebSocketEncodeData(Buffer::Ptr buffer) {
     _total_bytes_usage += buffer->size();
     send(std::move(buffer));
@@ -798,4 +947,16 @@ std::shared_ptr<FlvMuxer> HttpSession::getSharedPtr() {
     return dynamic_pointer_cast<FlvMuxer>(shared_from_this());
 }
 
+BackPressure::Action HttpSession::checkBackPressure(const RtmpMediaSource::RingDataType &pkt) {
+    auto action = _back_pressure.check(*this, pkt);
+    if (action == BackPressure::kActionDisconnect) {
+        shutdown(SockException(Err_shutdown, "flv player send queue overflow"));
+    }
+    return action;
+}
+
+void HttpSession::onDropVideo(size_t bytes) {
+    _back_pressure.onDropVideo(bytes);
+}
+
 } /* namespace mediakit */
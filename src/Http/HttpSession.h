@@ -26,7 +26,8 @@ namespace mediakit {
 class HttpSession: public toolkit::Session,
                    public FlvMuxer,
                    public HttpRequestSplitter,
-                   public WebSocketSplitter {
+                   public WebSocketSplitter,
+                   public BackPressureSession {
 public:
     using Ptr = std::shared_ptr<HttpSession>;
     using KeyValue = StrCaseMap;
@@ -46,12 +47,18 @@ public:
     void onManager() override;
     void setTimeoutSec(size_t second);
     void setMaxReqSize(size_t max_req_size);
+    //BackPressureSession override
+    const BackPressure &getBackPressure() const override { return _back_pressure; }
 
 protected:
     //FlvMuxer override
     void onWrite(const toolkit::Buffer::Ptr &data, bool flush) override ;
     void onDetach() override;
     std::shared_ptr<FlvMuxer> getSharedPtr() override;
+    BackPressure::Action checkBackPressure(const RtmpMediaSource::RingDataType &pkt) override;
+    void onDropVideo(size_t bytes) override;
+    bool isWebSocketFlv() const override { return _live_over_websocket; }
+    void onWriteWebSocketFrame(const toolkit::Buffer::Ptr &frame, bool flush) override;
 
     //HttpRequestSplitter override
     ssize_t onRecvHeader(const char *data,size_t len) override;
@@ -141,6 +148,8 @@ private:
     toolkit::Ticker _ticker;
     TSMediaSource::RingType::RingReader::Ptr _ts_reader;
     FMP4MediaSource::RingType::RingReader::Ptr _fmp4_reader;
+    //http-flv/ts/fmp4直播时的发送队列背压控制
+    BackPressure _back_pressure;
     //处理content数据的callback
     std::function<bool (const char *data,size_t len) > _on_recv_body;
 };
@@ -9,6 +9,7 @@
  */
 
 #include "WebSocketSplitter.h"
+#include <cstring>
 #include <sys/types.h>
 #if !defined(_WIN32)
 #include <sys/socket.h>
@@ -150,39 +151,47 @@ void WebSocketSplitter::onPayloadData(uint8_t *data, size_t len) {
     onWebSocketDecodePayload(*this, _mask_flag ? data - len : data, len, _payload_offset);
 }
 
-void WebSocketSplitter::encode(const WebSocketHeader &header,const Buffer::Ptr &buffer) {
-    string ret;
-    uint64_t len = buffer ? buffer->size() : 0;
-    uint8_t byte = header._fin << 7 | ((header._reserved & 0x07) << 4) | (header._opcode & 0x0F) ;
-    ret.push_back(byte);
+size_t WebSocketSplitter::encodeHeader(const WebSocketHeader &header, uint64_t len, uint8_t *out) {
+    auto ptr = out;
+    *ptr++ = header._fin << 7 | ((header._reserved & 0x07) << 4) | (header._opcode & 0x0F);
 
     auto mask_flag = (header._mask_flag && header._mask.size() >= 4);
-    byte = mask_flag << 7;
+    uint8_t byte = mask_flag << 7;
 
     if(len < 126){
         byte |= len;
-        ret.push_back(byte);
+        *ptr++ = byte;
     }else if(len <= 0xFFFF){
         byte |= 126;
-        ret.push_back(byte);
+        *ptr++ = byte;
 
         uint16_t len_low = htons((uint16_t)len);
-        ret.append((char *)&len_low,2);
+        memcpy(ptr, &len_low, 2);
+        ptr += 2;
     }else{
         byte |= 127;
-        ret.push_back(byte);
+        *ptr++ = byte;
 
         uint32_t len_high = htonl(len >> 32) ;
         uint32_t len_low = htonl(len & 0xFFFFFFFF);
-        ret.append((char *)&len_high,4);
-        ret.append((char *)&len_low,4);
+        memcpy(ptr, &len_high, 4);
+        memcpy(ptr + 4, &len_low, 4);
+        ptr += 8;
     }
     if(mask_flag){
-        ret.append((char *)header._mask.data(),4);
+        memcpy(ptr, header._mask.data(), 4);
+        ptr += 4;
     }
+    return ptr - out;
+}
 
-    onWebSocketEncodeData(std::make_shared<BufferString>(std::move(ret)));
+void WebSocketSplitter::encode(const WebSocketHeader &header,const Buffer::Ptr &buffer) {
+    uint64_t len = buffer ? buffer->size() : 0;
+    uint8_t head[kMaxHeaderSize];
+    auto head_size = encodeHeader(header, len, head);
+    onWebSocketEncodeData(std::make_shared<BufferString>(string((char *)head, head_size)));
 
+    auto mask_flag = (header._mask_flag && header._mask.size() >= 4);
     if(len > 0){
         if(mask_flag){
             uint8_t *ptr = (uint8_t*)buffer->data();
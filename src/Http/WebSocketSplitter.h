@@ -99,6 +99,18 @@ public:
      */
     void encode(const WebSocketHeader &header,const toolkit::Buffer::Ptr &buffer);
 
+    /**
+     * 生成websocket帧头
+     * @param header 数据头
+     * @param len 负载数据长度
+     * @param out 帧头输出地址，长度不得小于kMaxHeaderSize
+     * @return 帧头长度
+     */
+    static size_t encodeHeader(const WebSocketHeader &header, uint64_t len, uint8_t *out);
+
+    // 帧头最大长度(2字节基本头+8字节扩展长度+4字节掩码)
+    static constexpr size_t kMaxHeaderSize = 14;
+
 protected:
     /**
      * 收到一个webSocket数据包包头，后续将继续触发onWebSocketDecodePayload回调
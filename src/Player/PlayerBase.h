@@ -89,6 +89,14 @@ public:
      */
     virtual float getPacketLossRate(TrackType type) const { return -1; };
 
+    /**
+     * 获取rtp排序缓存状态，只支持rtsp
+     * @param type 音频或视频
+     * @param info 排序缓存状态
+     * @return 是否获取成功
+     */
+    virtual bool getJitterBufferInfo(TrackType type, JitterBufferInfo &info) const { return false; };
+
     /**
      * 获取所有track
      */
@@ -148,6 +156,10 @@ public:
         return _delegate ? _delegate->getPacketLossRate(type) : Parent::getPacketLossRate(type);
     }
 
+    bool getJitterBufferInfo(TrackType type, JitterBufferInfo &info) const override {
+        return _delegate ? _delegate->getJitterBufferInfo(type, info) : Parent::getJitterBufferInfo(type, info);
+    }
+
     float getDuration() const override {
         return _delegate ? _delegate->getDuration() : Parent::getDuration();
     }
@@ -283,6 +283,10 @@ float PlayerProxy::getLossRate(MediaSource &sender, TrackType type) {
     return getPacketLossRate(type);
 }
 
+bool PlayerProxy::getJitterBufferInfo(MediaSource &sender, TrackType type, JitterBufferInfo &info) {
+    return MediaPlayer::getJitterBufferInfo(type, info);
+}
+
 TranslationInfo PlayerProxy::getTranslationInfo() {
     return _transtalion_info;
 }
@@ -122,6 +122,7 @@ private:
     std::string getOriginUrl(MediaSource &sender) const override;
     std::shared_ptr<toolkit::SockInfo> getOriginSock(MediaSource &sender) const override;
     float getLossRate(MediaSource &sender, TrackType type) override;
+    bool getJitterBufferInfo(MediaSource &sender, TrackType type, JitterBufferInfo &info) override;
 
     void rePlay(const std::string &strUrl, int iFailedCnt);
     void onPlaySuccess();
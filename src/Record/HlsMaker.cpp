@@ -125,10 +125,6 @@ void HlsMaker::delOldSegment() {
     if (_file_index > _seg_number + segDelay) {
         _seg_dur_list.pop_front();
     }
-    //如果设置为一直保存，就不删除
-    if (_seg_keep) {
-        return;
-    }
     GET_CONFIG(uint32_t, segRetain, Hls::kSegmentRetain);
     //但是实际保存的切片个数比m3u8所述多若干个,这样做的目的是防止播放器在切片删除前能下载完毕
     if (_file_index > _seg_number + segDelay + segRetain) {
@@ -74,7 +74,7 @@ protected:
     virtual std::string onOpenSegment(uint64_t index) = 0;
 
     /**
-     * 删除ts切片文件回调
+     * 删除ts切片文件回调，开启保留切片(seg_keep)时也会回调，由子类决定是否删除磁盘文件
      * @param index
      */
     virtual void onDelSegment(uint64_t index) = 0;
@@ -14,6 +14,7 @@
 #include "Util/util.h"
 #include "Util/uv_errno.h"
 #include "Util/File.h"
+#include "Thread/WorkThreadPool.h"
 #include "Common/config.h"
 
 using namespace std;
@@ -39,6 +40,14 @@ HlsMakerImp::HlsMakerImp(bool is_fmp4, const string &m3u8_file, const string &pa
     _buf_size = bufSize;
     _file_buf.reset(new char[bufSize], [](char *ptr) { delete[] ptr; });
     _info.folder = _path_prefix;
+
+    GET_CONFIG(bool, memory_store, Hls::kMemoryStore);
+    // 点播(录制)仍然写磁盘
+    _memory_store = memory_store && isLive();
+    if (_memory_store && isKeep()) {
+        // 同一个线程按顺序落盘
+        _persist_executor = WorkThreadPool::Instance().getExecutor();
+    }
 }
 
 HlsMakerImp::~HlsMakerImp() {
@@ -54,7 +63,13 @@ void HlsMakerImp::clearCache() {
     clearCache(true, false);
 }
 
-static void clearHls(const std::list<std::string> &files) {
+static void clearHls(const std::list<std::string> &files, bool memory_store) {
+    if (memory_store) {
+        for (auto &file : files) {
+            HlsMemoryStore::Instance().del(file);
+        }
+        return;
+    }
     for (auto &file : files) {
         File::delete_file(file);
     }
@@ -64,7 +79,7 @@ static void clearHls(const std::list<std::string> &files) {
 void HlsMakerImp::clearCache(bool immediately, bool eof) {
     // 录制完了
     flushLastSegment(eof);
-    if (!isLive() || isKeep()) {
+    if (!isLive() || (isKeep() && !_memory_store)) {
         return;
     }
 
@@ -79,13 +94,21 @@ void HlsMakerImp::clearCache(bool immediately, bool eof) {
             lst.emplace_back(std::move(pr.second));
         }
 
+        if (isKeep()) {
+            // 切片已保留在磁盘上，等待落盘完毕后释放内存，此后http服务器从磁盘回复
+            _persist_executor->async([lst]() { clearHls(lst, true); }, false);
+            _segment_file_paths.clear();
+            return;
+        }
+
         // hls直播才删除文件
+        auto memory_store = _memory_store;
         GET_CONFIG(uint32_t, delay, Hls::kDeleteDelaySec);
         if (!delay || immediately) {
-            clearHls(lst);
+            clearHls(lst, memory_store);
         } else {
-            _poller->doDelayTask(delay * 1000, [lst]() {
-                clearHls(lst);
+            _poller->doDelayTask(delay * 1000, [lst, memory_store]() {
+                clearHls(lst, memory_store);
                 return 0;
             });
         }
@@ -93,9 +116,26 @@ void HlsMakerImp::clearCache(bool immediately, bool eof) {
 
     clear();
     _file = nullptr;
+    _segment = nullptr;
     _segment_file_paths.clear();
 }
 
+void HlsMakerImp::writeMemoryFile(const string &file, const Buffer::Ptr &data) {
+    HlsMemoryStore::Instance().add(file, data);
+    if (!_persist_executor) {
+        return;
+    }
+    _persist_executor->async([file, data]() {
+        auto fp = File::create_file(file.data(), "wb");
+        if (!fp) {
+            WarnL << "Create file failed," << file << " " << get_uv_errmsg();
+            return;
+        }
+        fwrite(data->data(), data->size(), 1, fp);
+        fclose(fp);
+    }, false);
+}
+
 string HlsMakerImp::onOpenSegment(uint64_t index) {
     string segment_name, segment_path;
     {
@@ -108,7 +148,11 @@ string HlsMakerImp::onOpenSegment(uint64_t index) {
             _segment_file_paths.emplace(index, segment_path);
         }
     }
-    _file = makeFile(segment_path, true);
+    if (_memory_store) {
+        _segment = std::make_shared<BufferLikeString>();
+    } else {
+        _file = makeFile(segment_path, true);
+    }
 
     // 保存本切片的元数据
     _info.start_time = ::time(NULL);
@@ -116,7 +160,7 @@ string HlsMakerImp::onOpenSegment(uint64_t index) {
     _info.file_path = segment_path;
     _info.url = _info.app + "/" + _info.stream + "/" + segment_name;
 
-    if (!_file) {
+    if (!_file && !_segment) {
         WarnL << "Create file failed," << segment_path << " " << get_uv_errmsg();
     }
     if (_params.empty()) {
@@ -130,12 +174,22 @@ void HlsMakerImp::onDelSegment(uint64_t index) {
     if (it == _segment_file_paths.end()) {
         return;
     }
-    File::delete_file(it->second.data(), true);
+    if (_memory_store) {
+        // 开启保留切片时，磁盘上的切片不删除
+        HlsMemoryStore::Instance().del(it->second);
+    } else if (!isKeep()) {
+        File::delete_file(it->second.data(), true);
+    }
     _segment_file_paths.erase(it);
 }
 
 void HlsMakerImp::onWriteInitSegment(const char *data, size_t len) {
     string init_seg_path = _path_prefix + "/init.mp4";
+    if (_memory_store) {
+        writeMemoryFile(init_seg_path, std::make_shared<BufferString>(string(data, len)));
+        _path_init = std::move(init_seg_path);
+        return;
+    }
     _file = makeFile(init_seg_path);
 
     if (_file) {
@@ -150,6 +204,8 @@ void HlsMakerImp::onWriteInitSegment(const char *data, size_t len) {
 void HlsMakerImp::onWriteSegment(const char *data, size_t len) {
     if (_file) {
         fwrite(data, len, 1, _file.get());
+    } else if (_segment) {
+        _segment->append(data, len);
     }
     if (_media_src) {
         _media_src->onSegmentSize(len);
@@ -158,6 +214,13 @@ void HlsMakerImp::onWriteSegment(const char *data, size_t len) {
 
 void HlsMakerImp::onWriteHls(const std::string &data, bool include_delay) {
     auto path = include_delay ? _path_hls_delay : _path_hls;
+    if (_memory_store) {
+        writeMemoryFile(path, std::make_shared<BufferString>(data));
+        if (_media_src && !include_delay) {
+            _media_src->setIndexFile(data);
+        }
+        return;
+    }
     auto hls = makeFile(path);
     if (hls) {
         fwrite(data.data(), data.size(), 1, hls.get());
@@ -173,11 +236,18 @@ void HlsMakerImp::onWriteHls(const std::string &data, bool include_delay) {
 void HlsMakerImp::onFlushLastSegment(uint64_t duration_ms) {
     // 关闭并flush文件到磁盘
     _file = nullptr;
+    size_t segment_size = 0;
+    if (_segment) {
+        // 切片写完后才可被访问，此后只读
+        segment_size = _segment->size();
+        writeMemoryFile(_info.file_path, _segment);
+        _segment = nullptr;
+    }
 
     GET_CONFIG(bool, broadcastRecordTs, Hls::kBroadcastRecordTs);
     if (broadcastRecordTs) {
         _info.time_len = duration_ms / 1000.0f;
-        _info.file_size = File::fileSize(_info.file_path.data());
+        _info.file_size = _memory_store ? segment_size : File::fileSize(_info.file_path.data());
         NOTICE_EMIT(BroadcastRecordTsArgs, Broadcast::kBroadcastRecordTs, _info);
     }
 }
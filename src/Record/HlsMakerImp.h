@@ -52,6 +52,7 @@ protected:
 private:
     std::shared_ptr<FILE> makeFile(const std::string &file,bool setbuf = false);
     void clearCache(bool immediately, bool eof);
+    void writeMemoryFile(const std::string &file, const toolkit::Buffer::Ptr &data);
 
 private:
     int _buf_size;
@@ -66,6 +67,12 @@ private:
     HlsMediaSource::Ptr _media_src;
     toolkit::EventPoller::Ptr _poller;
     std::map<uint64_t/*index*/,std::string/*file_path*/> _segment_file_paths;
+    // 切片与m3u8只保存在内存中
+    bool _memory_store = false;
+    // 正在写入的内存切片
+    std::shared_ptr<toolkit::BufferLikeString> _segment;
+    // 开启保留切片时，内存切片在该线程异步落盘
+    toolkit::TaskExecutor::Ptr _persist_executor;
 };
 
 }//namespace mediakit
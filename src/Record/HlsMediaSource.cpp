@@ -15,6 +15,45 @@ using namespace toolkit;
 
 namespace mediakit {
 
+HlsMemoryStore &HlsMemoryStore::Instance() {
+    static HlsMemoryStore s_instance;
+    return s_instance;
+}
+
+void HlsMemoryStore::add(const std::string &file_path, Buffer::Ptr data) {
+    std::lock_guard<std::mutex> lck(_mtx);
+    _files[file_path] = std::move(data);
+    _size = _files.size();
+}
+
+void HlsMemoryStore::del(const std::string &file_path) {
+    Buffer::Ptr data;
+    {
+        std::lock_guard<std::mutex> lck(_mtx);
+        auto it = _files.find(file_path);
+        if (it == _files.end()) {
+            return;
+        }
+        // 在锁外释放切片内存
+        data = std::move(it->second);
+        _files.erase(it);
+        _size = _files.size();
+    }
+}
+
+static bool isHlsFile(const std::string &file_path) {
+    return end_with(file_path, ".ts") || end_with(file_path, ".mp4") || end_with(file_path, ".m4s") || end_with(file_path, ".m3u8");
+}
+
+Buffer::Ptr HlsMemoryStore::find(const std::string &file_path) const {
+    if (!_size || !isHlsFile(file_path)) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lck(_mtx);
+    auto it = _files.find(file_path);
+    return it == _files.end() ? nullptr : it->second;
+}
+
 HlsCookieData::HlsCookieData(const MediaInfo &info, const std::shared_ptr<SockInfo> &sock_info) {
     _info = info;
     _sock_info = sock_info;
@@ -14,7 +14,9 @@
 #include "Common/MediaSource.h"
 #include "Util/TimeTicker.h"
 #include "Util/RingBuffer.h"
+#include "Network/Buffer.h"
 #include <atomic>
+#include <unordered_map>
 
 namespace mediakit {
 
@@ -69,6 +71,43 @@ private:
     toolkit::List<std::function<void(const std::string &)>> _list_cb;
 };
 
+/**
+ * hls内存切片存储，按切片(及m3u8、init.mp4)的绝对路径索引，
+ * http服务器直接从内存回复，不经过文件系统
+ */
+class HlsMemoryStore {
+public:
+    static HlsMemoryStore &Instance();
+
+    /**
+     * 添加或替换文件
+     * @param file_path 文件绝对路径，与http访问路径对应
+     * @param data 文件内容，只读，可被多个http回复同时引用
+     */
+    void add(const std::string &file_path, toolkit::Buffer::Ptr data);
+
+    /**
+     * 删除文件，正在发送该文件的http回复不受影响
+     */
+    void del(const std::string &file_path);
+
+    /**
+     * 查找文件，只有hls相关后缀(m3u8、切片、init.mp4)且存储非空时才加锁查找，
+     * 以便普通静态文件请求不争抢全局锁
+     * @return 不存在时返回nullptr
+     */
+    toolkit::Buffer::Ptr find(const std::string &file_path) const;
+
+private:
+    HlsMemoryStore() = default;
+
+private:
+    // 文件个数，为0时(未开启hls内存模式)查找不加锁
+    std::atomic<size_t> _size { 0 };
+    mutable std::mutex _mtx;
+    std::unordered_map<std::string, toolkit::Buffer::Ptr> _files;
+};
+
 class HlsCookieData {
 public:
     using Ptr = std::shared_ptr<HlsCookieData>;
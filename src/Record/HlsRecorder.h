@@ -68,6 +68,7 @@ public:
     }
 
     bool isEnabled() {
+        //hls不受warm-idle模式影响，只由hls_demand控制是否按需生成
         //缓存尚未清空时，还允许触发inputFrame函数，以便及时清空缓存
         return _option.hls_demand ? (_clear_cache ? true : _enabled) : true;
     }
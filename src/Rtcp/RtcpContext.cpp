@@ -192,10 +192,15 @@ void RtcpContextForRecv::onRtp(
 
         _last_rtp_seq = seq;
         _last_rtp_sys_stamp = sys_stamp;
+        _sample_rate = sample_rate;
     }
     RtcpContext::onRtp(seq, stamp, ntp_stamp_ms, sample_rate, bytes);
 }
 
+double RtcpContextForRecv::getJitterMS() const {
+    return _sample_rate ? _jitter * 1000 / _sample_rate : 0;
+}
+
 void RtcpContextForRecv::onRtcp(RtcpHeader *rtcp) {
     switch ((RtcpType)rtcp->pt) {
     case RtcpType::RTCP_SR: {
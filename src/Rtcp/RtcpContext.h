@@ -80,6 +80,11 @@ public:
      */
     virtual size_t getLostInterval();
 
+    /**
+     * 获取rtp到达时间抖动(rfc3550 interarrival jitter)，单位毫秒，仅接收者统计
+     */
+    virtual double getJitterMS() const { return 0; }
+
 protected:
     // 收到或发送的rtp的字节数
     size_t _bytes = 0;
@@ -121,11 +126,14 @@ public:
     size_t getExpectedPacketsInterval() override;
     size_t getLost() override;
     size_t getLostInterval() override;
+    double getJitterMS() const override;
     void onRtcp(RtcpHeader *rtcp) override;
 
 private:
     // 时间戳抖动值
     double _jitter = 0;
+    // rtp时间戳采样率，用于把抖动值转换为毫秒
+    uint32_t _sample_rate = 0;
     // 第一个seq的值
     uint16_t _seq_base = 0;
     // rtp最大seq
@@ -65,10 +65,23 @@ void FlvMuxer::start(const EventPoller::Ptr &poller, const RtmpMediaSource::Ptr
         if (!strong_self) {
             return;
         }
+        auto action = strong_self->checkBackPressure(pkt);
+        if (action == BackPressure::kActionDrop || action == BackPressure::kActionDisconnect) {
+            return;
+        }
 
         size_t i = 0;
         auto size = pkt->size();
+        if (action == BackPressure::kActionSendAudio) {
+            // 只发送音频，最后一个音频包刷新缓存
+            size = 0;
+            pkt->for_each([&](const RtmpPacket::Ptr &rtmp) { size += rtmp->type_id != MSG_VIDEO; });
+        }
         pkt->for_each([&](const RtmpPacket::Ptr &rtmp) {
+            if (action == BackPressure::kActionSendAudio && rtmp->type_id == MSG_VIDEO) {
+                strong_self->onDropVideo(rtmp->size());
+                return;
+            }
             if (check) {
                 if (rtmp->time_stamp < start_pts) {
                     return;
@@ -124,10 +137,6 @@ void FlvMuxer::onWriteFlvHeader(const RtmpMediaSource::Ptr &src) {
     });
 }
 
-void FlvMuxer::onWriteFlvTag(const RtmpPacket::Ptr &pkt, uint32_t time_stamp, bool flush) {
-    onWriteFlvTag(pkt->type_id, pkt, time_stamp, flush);
-}
-
 void FlvMuxer::onWriteFlvTag(uint8_t type, const Buffer::Ptr &buffer, uint32_t time_stamp, bool flush) {
     RtmpTagHeader header;
     header.type = type;
@@ -146,8 +155,81 @@ void FlvMuxer::onWriteFlvTag(uint8_t type, const Buffer::Ptr &buffer, uint32_t t
     onWrite(obtainBuffer((char *) &size, 4), flush);
 }
 
+struct RtmpPacket::FlvTagCache {
+    uint32_t time_stamp;
+    // tag头+tag数据+PreviousTagSize
+    Buffer::Ptr flv_tag;
+    // 封装为websocket二进制帧的flv tag
+    Buffer::Ptr websocket_frame;
+};
+
+std::shared_ptr<RtmpPacket::FlvTagCache> FlvMuxer::getFlvTagCache(const RtmpPacket::Ptr &pkt) {
+    auto cache = std::atomic_load(&pkt->_flv_tag);
+    if (cache && cache->time_stamp == pkt->time_stamp) {
+        return cache;
+    }
+    if (!pkt->_live_edge) {
+        //已不是最新的包(可能在gop缓存中)，不再生成flv tag缓存
+        return nullptr;
+    }
+
+    // flv tag前预留websocket帧头空间，http-flv与websocket-flv共用同一份内存
+    auto reserve = WebSocketSplitter::kMaxHeaderSize;
+    auto tag_size = sizeof(RtmpTagHeader) + pkt->size() + 4;
+    auto buffer = BufferRaw::create();
+    buffer->setCapacity(reserve + tag_size);
+    buffer->setSize(reserve + tag_size);
+    auto ptr = buffer->data() + reserve;
+
+    //tag header
+    RtmpTagHeader header;
+    header.type = pkt->type_id;
+    set_be24(header.data_size, (uint32_t) pkt->size());
+    header.timestamp_ex = (pkt->time_stamp >> 24) & 0xff;
+    set_be24(header.timestamp, pkt->time_stamp & 0xFFFFFF);
+    memcpy(ptr, &header, sizeof(header));
+
+    //tag data
+    memcpy(ptr + sizeof(header), pkt->data(), pkt->size());
+
+    //PreviousTagSize
+    set_be32(ptr + sizeof(header) + pkt->size(), (uint32_t) (pkt->size() + sizeof(header)));
+
+    //websocket帧头
+    WebSocketHeader ws_header;
+    ws_header._fin = true;
+    ws_header._reserved = 0;
+    ws_header._opcode = WebSocketHeader::BINARY;
+    ws_header._mask_flag = false;
+    uint8_t ws_head[WebSocketSplitter::kMaxHeaderSize];
+    auto ws_head_size = WebSocketSplitter::encodeHeader(ws_header, tag_size, ws_head);
+    memcpy(ptr - ws_head_size, ws_head, ws_head_size);
+
+    cache = std::make_shared<RtmpPacket::FlvTagCache>();
+    cache->time_stamp = pkt->time_stamp;
+    cache->flv_tag = std::make_shared<BufferPartial>(buffer, reserve, tag_size);
+    cache->websocket_frame = std::make_shared<BufferPartial>(buffer, reserve - ws_head_size, ws_head_size + tag_size);
+    std::atomic_store(&pkt->_flv_tag, cache);
+    if (!pkt->_live_edge) {
+        //生成期间并发调用了leaveLiveEdge，不保留flv tag缓存
+        std::atomic_store(&pkt->_flv_tag, std::shared_ptr<RtmpPacket::FlvTagCache>());
+    }
+    return cache;
+}
+
 void FlvMuxer::onWriteRtmp(const RtmpPacket::Ptr &pkt, bool flush) {
-    onWriteFlvTag(pkt, pkt->time_stamp, flush);
+    // 同一个rtmp包只序列化一次，所有播放器共享
+    auto cache = getFlvTagCache(pkt);
+    if (!cache) {
+        //包已不是最新，没有共享的flv tag缓存，分段发送
+        onWriteFlvTag(pkt->type_id, pkt, pkt->time_stamp, flush);
+        return;
+    }
+    if (isWebSocketFlv()) {
+        onWriteWebSocketFrame(cache->websocket_frame, flush);
+    } else {
+        onWrite(cache->flv_tag, flush);
+    }
 }
 
 void FlvMuxer::stop() {
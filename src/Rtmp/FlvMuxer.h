@@ -14,6 +14,7 @@
 #include "Rtmp/Rtmp.h"
 #include "Rtmp/RtmpMediaSource.h"
 #include "Poller/EventPoller.h"
+#include "Common/BackPressure.h"
 
 namespace mediakit {
 
@@ -30,12 +31,28 @@ protected:
     virtual void onWrite(const toolkit::Buffer::Ptr &data, bool flush) = 0;
     virtual void onDetach() = 0;
     virtual std::shared_ptr<FlvMuxer> getSharedPtr() = 0;
+    /**
+     * 收到环形缓存数据时判断如何发送，用于慢速播放器背压控制，默认全部发送(例如录制flv文件)
+     */
+    virtual BackPressure::Action checkBackPressure(const RtmpMediaSource::RingDataType &pkt) { return BackPressure::kActionSend; }
+    /**
+     * 背压控制只发送音频时，统计被丢弃的视频数据
+     */
+    virtual void onDropVideo(size_t bytes) {}
+    /**
+     * 是否为websocket-flv，是则通过onWriteWebSocketFrame发送已封装好的websocket帧
+     */
+    virtual bool isWebSocketFlv() const { return false; }
+    /**
+     * 发送已封装好帧头的websocket帧，每个flv tag一帧，由所有播放器共享
+     */
+    virtual void onWriteWebSocketFrame(const toolkit::Buffer::Ptr &frame, bool flush) {}
 
 private:
     void onWriteFlvHeader(const RtmpMediaSource::Ptr &src);
     void onWriteRtmp(const RtmpPacket::Ptr &pkt, bool flush);
-    void onWriteFlvTag(const RtmpPacket::Ptr &pkt, uint32_t time_stamp, bool flush);
     void onWriteFlvTag(uint8_t type, const toolkit::Buffer::Ptr &buffer, uint32_t time_stamp, bool flush);
+    static std::shared_ptr<RtmpPacket::FlvTagCache> getFlvTagCache(const RtmpPacket::Ptr &pkt);
     toolkit::BufferRaw::Ptr obtainBuffer(const void *data, size_t len);
     toolkit::BufferRaw::Ptr obtainBuffer();
 
@@ -8,7 +8,9 @@
  * may be found in the AUTHORS file in the root of the source tree.
  */
 
+#include <algorithm>
 #include "Rtmp.h"
+#include "utils.h"
 #include "Common/config.h"
 #include "Extension/Factory.h"
 
@@ -151,6 +153,82 @@ void RtmpPacket::clear() {
     ts_field = 0;
     body_size = 0;
     buffer.clear();
+    _live_edge = true;
+    std::atomic_store(&_chunked, std::shared_ptr<ChunkedCache>());
+    std::atomic_store(&_flv_tag, std::shared_ptr<FlvTagCache>());
+}
+
+struct RtmpPacket::ChunkedCache {
+    size_t chunk_size;
+    uint32_t stream_index;
+    uint32_t time_stamp;
+    toolkit::Buffer::Ptr buffer;
+};
+
+toolkit::Buffer::Ptr RtmpPacket::getChunkedBuffer(size_t chunk_size, uint32_t stream_index) {
+    auto cache = std::atomic_load(&_chunked);
+    if (cache && cache->chunk_size == chunk_size && cache->stream_index == stream_index && cache->time_stamp == time_stamp) {
+        return cache->buffer;
+    }
+    if (!_live_edge) {
+        //已不是最新的包(可能在gop缓存中)，不再生成切片缓存
+        return nullptr;
+    }
+
+    //是否有扩展时间戳
+    bool ext_stamp = time_stamp >= 0xFFFFFF;
+    auto body = size();
+    auto chunk_count = body ? (body + chunk_size - 1) / chunk_size : 0;
+    auto ret = toolkit::BufferRaw::create();
+    ret->setCapacity(sizeof(RtmpHeader) + body + (chunk_count ? chunk_count - 1 : 0) + (ext_stamp ? 4 * chunk_count : 0));
+
+    //rtmp头，如果使用整形赋值，在arm android上可能由于数据对齐导致总线错误的问题
+    auto ptr = ret->data();
+    auto header = (RtmpHeader *)ptr;
+    header->fmt = 0;
+    header->chunk_id = chunk_id;
+    header->type_id = type_id;
+    set_be24(header->time_stamp, ext_stamp ? 0xFFFFFF : time_stamp);
+    set_be24(header->body_size, (uint32_t)body);
+    set_le32(header->stream_index, stream_index);
+    ptr += sizeof(RtmpHeader);
+
+    for (size_t offset = 0; offset < body;) {
+        if (offset) {
+            //一个字节的flag，标明是什么chunkId
+            header = (RtmpHeader *)ptr;
+            header->fmt = 3;
+            header->chunk_id = chunk_id;
+            ptr += 1;
+        }
+        if (ext_stamp) {
+            set_be32(ptr, time_stamp);
+            ptr += 4;
+        }
+        auto chunk = std::min(chunk_size, body - offset);
+        memcpy(ptr, data() + offset, chunk);
+        ptr += chunk;
+        offset += chunk;
+    }
+    ret->setSize(ptr - ret->data());
+
+    cache = std::make_shared<ChunkedCache>();
+    cache->chunk_size = chunk_size;
+    cache->stream_index = stream_index;
+    cache->time_stamp = time_stamp;
+    cache->buffer = ret;
+    std::atomic_store(&_chunked, cache);
+    if (!_live_edge) {
+        //生成期间并发调用了leaveLiveEdge，不保留切片缓存
+        std::atomic_store(&_chunked, std::shared_ptr<ChunkedCache>());
+    }
+    return ret;
+}
+
+void RtmpPacket::leaveLiveEdge() {
+    _live_edge = false;
+    std::atomic_store(&_chunked, std::shared_ptr<ChunkedCache>());
+    std::atomic_store(&_flv_tag, std::shared_ptr<FlvTagCache>());
 }
 
 bool RtmpPacket::isVideoKeyFrame() const {
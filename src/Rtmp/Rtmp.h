@@ -13,6 +13,7 @@
 
 #include <memory>
 #include <string>
+#include <atomic>
 #include <cstdlib>
 #include "amf.h"
 #include "Network/Buffer.h"
@@ -160,6 +161,31 @@ struct RtmpVideoHeaderClassic {
 
 #pragma pack(pop)
 
+/**
+ * 引用另一个buffer的一部分，不拷贝数据
+ */
+class BufferPartial : public toolkit::Buffer {
+public:
+    BufferPartial(const toolkit::Buffer::Ptr &buffer, size_t offset, size_t size) {
+        _buffer = buffer;
+        _data = buffer->data() + offset;
+        _size = size;
+    }
+
+    char *data() const override {
+        return _data;
+    }
+
+    size_t size() const override{
+        return _size;
+    }
+
+private:
+    char *_data;
+    size_t _size;
+    toolkit::Buffer::Ptr _buffer;
+};
+
 class RtmpPacket : public toolkit::Buffer{
 public:
     friend class RtmpProtocol;
@@ -198,7 +224,22 @@ public:
     int getAudioSampleBit() const;
     int getAudioChannel() const;
 
+    /**
+     * 获取按块大小切片后的rtmp消息(含块头与扩展时间戳)
+     * 同一个rtmp包只切片一次，块大小与消息流id相同的播放器共享同一份数据
+     * @param chunk_size 输出块大小
+     * @param stream_index 消息流id
+     * @return 包已不是最新(调用过leaveLiveEdge)时返回nullptr，此时应逐块发送
+     */
+    toolkit::Buffer::Ptr getChunkedBuffer(size_t chunk_size, uint32_t stream_index);
+
+    /**
+     * 有更新的包写入环形缓存后由媒体源调用，释放切片缓存与flv tag缓存且不再生成，避免gop缓存占用双倍内存
+     */
+    void leaveLiveEdge();
+
 private:
+    friend class FlvMuxer;
     friend class toolkit::ResourcePool_l<RtmpPacket>;
     RtmpPacket(){
         clear();
@@ -207,6 +248,14 @@ private:
     RtmpPacket &operator=(const RtmpPacket &that);
 
 private:
+    // 是否为最新写入环形缓存的包，只有最新的包才缓存切片与flv tag
+    std::atomic<bool> _live_edge { true };
+    struct ChunkedCache;
+    // 切片缓存，可能被多个播放器线程同时访问，通过std::atomic_load/atomic_store读写
+    std::shared_ptr<ChunkedCache> _chunked;
+    // flv tag缓存，由FlvMuxer生成，所有http-flv/websocket-flv播放器共享
+    struct FlvTagCache;
+    std::shared_ptr<FlvTagCache> _flv_tag;
     //对象个数统计
     toolkit::ObjectStatistic<RtmpPacket> _statistic;
 };
@@ -36,7 +36,7 @@ namespace mediakit {
 class RtmpMediaSource : public MediaSource, public toolkit::RingDelegate<RtmpPacket::Ptr>, private PacketCache<RtmpPacket>{
 public:
     using Ptr = std::shared_ptr<RtmpMediaSource>;
-    using RingDataType = std::shared_ptr<toolkit::List<RtmpPacket::Ptr> >;
+    using RingDataType = std::shared_ptr<PacketList<RtmpPacket::Ptr> >;
     using RingType = toolkit::RingBuffer<RingDataType>;
 
     /**
@@ -127,14 +127,22 @@ private:
     * @param rtmp_list rtmp包列表
     * @param key_pos 是否包含关键帧
     */
-    void onFlush(std::shared_ptr<toolkit::List<RtmpPacket::Ptr> > rtmp_list, bool key_pos) override {
+    void onFlush(std::shared_ptr<PacketList<RtmpPacket::Ptr> > rtmp_list, bool key_pos) override {
         //如果不存在视频，那么就没有存在GOP缓存的意义，所以is_key一直为true确保一直清空GOP缓存
-        _ring->write(std::move(rtmp_list), _have_video ? key_pos : true);
+        key_pos = _have_video ? key_pos : true;
+        rtmp_list->key_pos = key_pos;
+        //上一个列表只可能留在gop缓存中或被落后的播放器发送，释放其中包的序列化缓存
+        if (auto last_list = _last_list.lock()) {
+            last_list->for_each([](const RtmpPacket::Ptr &pkt) { pkt->leaveLiveEdge(); });
+        }
+        _last_list = rtmp_list;
+        _ring->write(std::move(rtmp_list), key_pos);
     }
 
 private:
     bool _have_video = false;
     bool _have_audio = false;
+    std::weak_ptr<PacketList<RtmpPacket::Ptr> > _last_list;
     int _ring_size;
     uint32_t _track_stamps[TrackMax] = {0};
     AMFValue _metadata;
@@ -179,28 +179,6 @@ void RtmpProtocol::sendRequest(int cmd, const string& str) {
     }
 }
 
-class BufferPartial : public Buffer {
-public:
-    BufferPartial(const Buffer::Ptr &buffer, size_t offset, size_t size) {
-        _buffer = buffer;
-        _data = buffer->data() + offset;
-        _size = size;
-    }
-
-    char *data() const override {
-        return _data;
-    }
-
-    size_t size() const override{
-        return _size;
-    }
-
-private:
-    char *_data;
-    size_t _size;
-    Buffer::Ptr _buffer;
-};
-
 void RtmpProtocol::sendRtmp(uint8_t type, uint32_t stream_index, const std::string &buffer, uint32_t stamp, int chunk_id) {
     sendRtmp(type, stream_index, std::make_shared<BufferString>(buffer), stamp, chunk_id);
 }
@@ -263,7 +241,28 @@ void RtmpProtocol::sendRtmp(uint8_t type, uint32_t stream_index, const Buffer::P
         totalSize += chunk;
         offset += chunk;
     }
-    _bytes_sent += (uint32_t)totalSize;
+    onSendRtmpBytes(totalSize);
+}
+
+void RtmpProtocol::sendRtmp(const RtmpPacket::Ptr &pkt, uint32_t stream_index) {
+    if (pkt->chunk_id < 2 || pkt->chunk_id > 63) {
+        //不支持的块流id，由原接口抛异常
+        sendRtmp(pkt->type_id, stream_index, pkt, pkt->time_stamp, pkt->chunk_id);
+        return;
+    }
+    auto buffer = pkt->getChunkedBuffer(_chunk_size_out, stream_index);
+    if (!buffer) {
+        //包已不是最新，没有共享的切片缓存，逐块发送
+        sendRtmp(pkt->type_id, stream_index, pkt, pkt->time_stamp, pkt->chunk_id);
+        return;
+    }
+    auto size = buffer->size();
+    onSendRawData(std::move(buffer));
+    onSendRtmpBytes(size);
+}
+
+void RtmpProtocol::onSendRtmpBytes(size_t bytes) {
+    _bytes_sent += (uint32_t)bytes;
     if (_windows_size > 0 && _bytes_sent - _bytes_sent_last >= _windows_size) {
         _bytes_sent_last = _bytes_sent;
         sendAcknowledgement(_bytes_sent);
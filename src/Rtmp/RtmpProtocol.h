@@ -61,6 +61,8 @@ protected:
     void sendResponse(int type, const std::string &str);
     void sendRtmp(uint8_t type, uint32_t stream_index, const std::string &buffer, uint32_t stamp, int chunk_id);
     void sendRtmp(uint8_t type, uint32_t stream_index, const toolkit::Buffer::Ptr &buffer, uint32_t stamp, int chunk_id);
+    // 发送媒体包，切片结果缓存在rtmp包中，多个播放器共享
+    void sendRtmp(const RtmpPacket::Ptr &pkt, uint32_t stream_index);
     toolkit::BufferRaw::Ptr obtainBuffer(const void *data = nullptr, size_t len = 0);
 
 private:
@@ -78,6 +80,7 @@ private:
     const char* handle_C2(const char *data, size_t len);
     const char* handle_rtmp(const char *data, size_t len);
     void handle_chunk(RtmpPacket::Ptr chunk_data);
+    void onSendRtmpBytes(size_t bytes);
 
 protected:
     int _send_req_id = 0;
@@ -314,10 +314,27 @@ void RtmpSession::sendPlayResponse(const string &err, const RtmpMediaSource::Ptr
         if (!strong_self) {
             return;
         }
+        auto action = strong_self->_back_pressure.check(*strong_self, pkt);
+        if (action == BackPressure::kActionDisconnect) {
+            strong_self->shutdown(SockException(Err_shutdown, "rtmp player send queue overflow"));
+            return;
+        }
+        if (action == BackPressure::kActionDrop) {
+            return;
+        }
         size_t i = 0;
         auto size = pkt->size();
+        if (action == BackPressure::kActionSendAudio) {
+            // 只发送音频，最后一个音频包刷新缓存
+            size = 0;
+            pkt->for_each([&](const RtmpPacket::Ptr &rtmp) { size += rtmp->type_id != MSG_VIDEO; });
+        }
         strong_self->setSendFlushFlag(false);
         pkt->for_each([&](const RtmpPacket::Ptr &rtmp){
+            if (action == BackPressure::kActionSendAudio && rtmp->type_id == MSG_VIDEO) {
+                strong_self->_back_pressure.onDropVideo(rtmp->size());
+                return;
+            }
             if(++i == size){
                 strong_self->setSendFlushFlag(true);
             }
@@ -585,7 +602,7 @@ void RtmpSession::onCmd_seek(AMFDecoder &dec) {
 }
 
 void RtmpSession::onSendMedia(const RtmpPacket::Ptr &pkt) {
-    sendRtmp(pkt->type_id, pkt->stream_index, pkt, pkt->time_stamp, pkt->chunk_id);
+    sendRtmp(pkt, pkt->stream_index);
 }
 
 bool RtmpSession::close(MediaSource &sender) {
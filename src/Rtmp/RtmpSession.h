@@ -19,10 +19,11 @@
 #include "RtmpMediaSourceImp.h"
 #include "Util/TimeTicker.h"
 #include "Network/Session.h"
+#include "Common/BackPressure.h"
 
 namespace mediakit {
 
-class RtmpSession : public toolkit::Session, public RtmpProtocol, public MediaSourceEvent {
+class RtmpSession : public toolkit::Session, public RtmpProtocol, public MediaSourceEvent, public BackPressureSession {
 public:
     using Ptr = std::shared_ptr<RtmpSession>;
 
@@ -31,6 +32,8 @@ public:
     void onRecv(const toolkit::Buffer::Ptr &buf) override;
     void onError(const toolkit::SockException &err) override;
     void onManager() override;
+    ////BackPressureSession override////
+    const BackPressure &getBackPressure() const override { return _back_pressure; }
 
 private:
     void onProcessCmd(AMFDecoder &dec);
@@ -100,6 +103,8 @@ private:
     RtmpMediaSourceImp::Ptr _push_src;
     std::shared_ptr<void> _push_src_ownership;
     RtmpMediaSource::RingType::RingReader::Ptr _ring_reader;
+    //播放时的发送队列背压控制
+    BackPressure _back_pressure;
 };
 
 /**
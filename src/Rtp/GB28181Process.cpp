@@ -38,6 +38,7 @@ public:
         setBeforeSorted(std::move(cb_before));
         // GB28181推流不支持ntp时间戳
         setNtpStamp(0, 0);
+        enableAdaptiveJitter();
     }
 
     bool inputRtp(TrackType type, uint8_t *ptr, size_t len) {
@@ -60,6 +61,21 @@ void GB28181Process::onRtpSorted(RtpPacket::Ptr rtp) {
     _rtp_decoder[rtp->getHeader()->pt]->inputRtp(rtp, false);
 }
 
+void GB28181Process::setJitterMS(double jitter_ms) {
+    for (auto &pr : _rtp_receiver) {
+        pr.second->setJitterMS(jitter_ms);
+    }
+}
+
+bool GB28181Process::getJitterBufferInfo(JitterBufferInfo &info) const {
+    if (_rtp_receiver.empty()) {
+        return false;
+    }
+    // 一般只有一路ps/ts rtp
+    _rtp_receiver.begin()->second->getJitterBufferInfo(info);
+    return true;
+}
+
 void GB28181Process::flush() {
     if (_decoder) {
         _decoder->flush();
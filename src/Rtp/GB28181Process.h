@@ -41,6 +41,9 @@ public:
      */
     void flush() override;
 
+    void setJitterMS(double jitter_ms) override;
+    bool getJitterBufferInfo(JitterBufferInfo &info) const override;
+
 protected:
     void onRtpSorted(RtpPacket::Ptr rtp);
 
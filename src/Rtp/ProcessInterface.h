@@ -17,6 +17,8 @@
 
 namespace mediakit {
 
+struct JitterBufferInfo;
+
 class ProcessInterface {
 public:
     using Ptr = std::shared_ptr<ProcessInterface>;
@@ -35,6 +37,17 @@ public:
      * 刷新输出所有缓存
      */
     virtual void flush() {}
+
+    /**
+     * 设置网络抖动，用于自适应调整rtp排序窗口
+     * @param jitter_ms 抖动，单位毫秒
+     */
+    virtual void setJitterMS(double jitter_ms) {}
+
+    /**
+     * 获取rtp排序缓存状态
+     */
+    virtual bool getJitterBufferInfo(JitterBufferInfo &info) const { return false; }
 };
 
 }//namespace mediakit
@@ -21,7 +21,7 @@ namespace mediakit{
 
 class RtpCache : protected PacketCache<toolkit::Buffer> {
 public:
-    using onFlushed = std::function<void(std::shared_ptr<toolkit::List<toolkit::Buffer::Ptr> >)>;
+    using onFlushed = std::function<void(std::shared_ptr<PacketList<toolkit::Buffer::Ptr> >)>;
     RtpCache(onFlushed cb);
 
 protected:
@@ -32,7 +32,7 @@ protected:
     void input(uint64_t stamp, toolkit::Buffer::Ptr buffer,bool is_key = false);
 
 protected:
-    void onFlush(std::shared_ptr<toolkit::List<toolkit::Buffer::Ptr> > rtp_list, bool) override;
+    void onFlush(std::shared_ptr<PacketList<toolkit::Buffer::Ptr> > rtp_list, bool) override;
 
 private:
     onFlushed _cb;
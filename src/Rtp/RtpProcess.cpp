@@ -13,6 +13,7 @@
 #include "RtpProcess.h"
 #include "RtpSelector.h"
 #include "Http/HttpTSPlayer.h"
+#include "Rtsp/RtpReceiver.h"
 #include "Util/File.h"
 #include "Common/config.h"
 
@@ -106,6 +107,8 @@ bool RtpProcess::inputRtp(bool is_udp, const Socket::Ptr &sock, const char *data
 
     auto header = (RtpHeader *) data;
     onRtp(ntohs(header->seq), ntohl(header->stamp), 0/*不发送sr,所以可以设置为0*/ , 90000/*ps/ts流时间戳按照90K采样率*/, len);
+    //根据统计的网络抖动调整排序窗口
+    _process->setJitterMS(getJitterMS());
 
     GET_CONFIG(string, dump_dir, RtpProxy::kDumpDir);
     if (_muxer && !_muxer->isEnabled() && !dts_out && dump_dir.empty()) {
@@ -121,6 +124,19 @@ bool RtpProcess::inputRtp(bool is_udp, const Socket::Ptr &sock, const char *data
     return ret;
 }
 
+size_t RtpProcess::inputRtp(const Socket::Ptr &sock, const Buffer::Ptr *buf, const struct sockaddr_storage *addr, size_t count) {
+    size_t ret = 0;
+    for (size_t i = 0; i < count; ++i) {
+        try {
+            ret += inputRtp(true, sock, buf[i]->data(), buf[i]->size(), (const struct sockaddr *)(addr + i));
+        } catch (RtpTrack::BadRtpException &ex) {
+            //单个坏包不影响同一批次的其他包
+            WarnP(this) << ex.what();
+        }
+    }
+    return ret;
+}
+
 bool RtpProcess::inputFrame(const Frame::Ptr &frame) {
     _dts = frame->dts();
     if (_save_file_video && frame->getTrackType() == TrackVideo) {
@@ -309,5 +325,9 @@ float RtpProcess::getLossRate(MediaSource &sender, TrackType type) {
     return getLostInterval() * 100 / expected;
 }
 
+bool RtpProcess::getJitterBufferInfo(MediaSource &sender, TrackType type, JitterBufferInfo &info) {
+    return _process && _process->getJitterBufferInfo(info);
+}
+
 }//namespace mediakit
 #endif//defined(ENABLE_RTPPROXY)
\ No newline at end of file
@@ -38,6 +38,16 @@ public:
      */
     bool inputRtp(bool is_udp, const toolkit::Socket::Ptr &sock, const char *data, size_t len, const struct sockaddr *addr , uint64_t *dts_out = nullptr);
 
+    /**
+     * 批量输入udp rtp，用于recvmmsg一次读取到的多个包
+     * @param sock 本地监听的socket
+     * @param buf rtp包数组
+     * @param addr 数据源地址数组，与buf一一对应
+     * @param count 包个数
+     * @return 解析成功的包个数
+     */
+    size_t inputRtp(const toolkit::Socket::Ptr &sock, const toolkit::Buffer::Ptr *buf, const struct sockaddr_storage *addr, size_t count);
+
     /**
      * 是否超时，用于超时移除对象
      */
@@ -88,6 +98,7 @@ protected:
     std::shared_ptr<SockInfo> getOriginSock(MediaSource &sender) const override;
     toolkit::EventPoller::Ptr getOwnerPoller(MediaSource &sender) override;
     float getLossRate(MediaSource &sender, TrackType type) override;
+    bool getJitterBufferInfo(MediaSource &sender, TrackType type, JitterBufferInfo &info) override;
 
 private:
     void emitOnPublish();
@@ -21,9 +21,39 @@ namespace mediakit{
 INSTANCE_IMP(RtpSelector);
 
 void RtpSelector::clear(){
-    lock_guard<decltype(_mtx_map)> lck(_mtx_map);
-    _map_rtp_process.clear();
+    for (auto &shard : _shards) {
+        //RtpProcessHelper析构时可能同步触发flush及事件广播，需在解锁后释放，防止监听者重入本对象死锁
+        decltype(shard.map_rtp_process) released;
+        {
+            lock_guard<mutex> lck(shard.mtx);
+            released.swap(shard.map_rtp_process);
+        }
+    }
+    lock_guard<mutex> lck(_mtx_stream_replace);
     _map_stream_replace.clear();
+    _stream_replace_size = 0;
+}
+
+size_t RtpSelector::size() {
+    size_t ret = 0;
+    for (auto &shard : _shards) {
+        lock_guard<mutex> lck(shard.mtx);
+        ret += shard.map_rtp_process.size();
+    }
+    return ret;
+}
+
+RtpSelector::Shard &RtpSelector::getShard(const string &stream_id) {
+    return _shards[hash<string>()(stream_id) % kShardCount];
+}
+
+string RtpSelector::getOriginStreamId(const string &stream_id) {
+    if (!_stream_replace_size) {
+        return stream_id;
+    }
+    lock_guard<mutex> lck(_mtx_stream_replace);
+    auto it_replace = _map_stream_replace.find(stream_id);
+    return it_replace != _map_stream_replace.end() ? it_replace->second : stream_id;
 }
 
 bool RtpSelector::getSSRC(const char *data, size_t data_len, uint32_t &ssrc){
@@ -36,32 +66,32 @@ bool RtpSelector::getSSRC(const char *data, size_t data_len, uint32_t &ssrc){
 }
 
 RtpProcess::Ptr RtpSelector::getProcess(const string &stream_id,bool makeNew) {
-    lock_guard<decltype(_mtx_map)> lck(_mtx_map);
-    string stream_id_origin = stream_id;
-    auto it_replace = _map_stream_replace.find(stream_id);
-    if (it_replace != _map_stream_replace.end()) {
-        stream_id_origin = it_replace->second;
-    }
-
-    auto it = _map_rtp_process.find(stream_id_origin);
-    if (it == _map_rtp_process.end() && !makeNew) {
-        return nullptr;
-    }
-    if (it != _map_rtp_process.end() && makeNew) {
-        //已经被其他线程持有了，不得再被持有，否则会存在线程安全的问题
-        throw ProcessExisted(StrPrinter << "RtpProcess(" << stream_id_origin << ") already existed");
-    }
-    RtpProcessHelper::Ptr &ref = _map_rtp_process[stream_id_origin];
-    if (!ref) {
-        ref = std::make_shared<RtpProcessHelper>(stream_id_origin, shared_from_this());
-        ref->attachEvent();
-        createTimer();
+    auto stream_id_origin = getOriginStreamId(stream_id);
+    auto &shard = getShard(stream_id_origin);
+    RtpProcessHelper::Ptr helper;
+    {
+        lock_guard<mutex> lck(shard.mtx);
+        auto it = shard.map_rtp_process.find(stream_id_origin);
+        if (it == shard.map_rtp_process.end() && !makeNew) {
+            return nullptr;
+        }
+        if (it != shard.map_rtp_process.end() && makeNew) {
+            //已经被其他线程持有了，不得再被持有，否则会存在线程安全的问题
+            throw ProcessExisted(StrPrinter << "RtpProcess(" << stream_id_origin << ") already existed");
+        }
+        RtpProcessHelper::Ptr &ref = shard.map_rtp_process[stream_id_origin];
+        if (!ref) {
+            ref = std::make_shared<RtpProcessHelper>(stream_id_origin, shared_from_this());
+            ref->attachEvent();
+        }
+        helper = ref;
     }
-    return ref->getProcess();
+    createTimer();
+    return helper->getProcess();
 }
 
 void RtpSelector::createTimer() {
-    if (!_timer) {
+    std::call_once(_timer_flag, [this]() {
         //创建超时管理定时器
         weak_ptr<RtpSelector> weakSelf = shared_from_this();
         _timer = std::make_shared<Timer>(3.0f, [weakSelf] {
@@ -72,57 +102,76 @@ void RtpSelector::createTimer() {
             strongSelf->onManager();
             return true;
         }, EventPollerPool::Instance().getPoller());
-    }
+    });
 }
 
 void RtpSelector::delProcess(const string &stream_id,const RtpProcess *ptr) {
     RtpProcess::Ptr process;
+    //在解锁后才析构
+    RtpProcessHelper::Ptr helper;
     {
-        lock_guard<decltype(_mtx_map)> lck(_mtx_map);
-        auto it = _map_rtp_process.find(stream_id);
-        if (it == _map_rtp_process.end()) {
+        auto &shard = getShard(stream_id);
+        lock_guard<mutex> lck(shard.mtx);
+        auto it = shard.map_rtp_process.find(stream_id);
+        if (it == shard.map_rtp_process.end()) {
             return;
         }
         if (it->second->getProcess().get() != ptr) {
             return;
         }
         process = it->second->getProcess();
-        _map_rtp_process.erase(it);
-        delStreamReplace(stream_id);
+        helper = std::move(it->second);
+        shard.map_rtp_process.erase(it);
     }
+    delStreamReplace(stream_id);
     process->onDetach();
 }
 
 void RtpSelector::addStreamReplace(const string &stream_id, const std::string &stream_replace) {
-    lock_guard<decltype(_mtx_map)> lck(_mtx_map);
+    lock_guard<mutex> lck(_mtx_stream_replace);
     _map_stream_replace[stream_replace] = stream_id;
+    _stream_replace_size = _map_stream_replace.size();
 }
 
 void RtpSelector::delStreamReplace(const string &stream_id) {
+    if (!_stream_replace_size) {
+        return;
+    }
+    lock_guard<mutex> lck(_mtx_stream_replace);
     for (auto it = _map_stream_replace.begin(); it != _map_stream_replace.end(); ++it) {
         if (it->second == stream_id) {
             _map_stream_replace.erase(it);
             break;
         }
     }
+    _stream_replace_size = _map_stream_replace.size();
 }
 
 void RtpSelector::onManager() {
     List<RtpProcess::Ptr> clear_list;
-    {
-        lock_guard<decltype(_mtx_map)> lck(_mtx_map);
-        for (auto it = _map_rtp_process.begin(); it != _map_rtp_process.end();) {
+    List<string> clear_ids;
+    //在解锁后才析构
+    List<RtpProcessHelper::Ptr> clear_helpers;
+    for (auto &shard : _shards) {
+        //逐个分片清理，避免长时间持有锁阻塞其他分片的创建与查找
+        lock_guard<mutex> lck(shard.mtx);
+        for (auto it = shard.map_rtp_process.begin(); it != shard.map_rtp_process.end();) {
             if (it->second->getProcess()->alive()) {
                 ++it;
                 continue;
             }
             WarnL << "RtpProcess timeout:" << it->first;
             clear_list.emplace_back(it->second->getProcess());
-            delStreamReplace(it->first);
-            it = _map_rtp_process.erase(it);
+            clear_ids.emplace_back(it->first);
+            clear_helpers.emplace_back(std::move(it->second));
+            it = shard.map_rtp_process.erase(it);
         }
     }
 
+    clear_ids.for_each([this](const string &stream_id) {
+        delStreamReplace(stream_id);
+    });
+
     clear_list.for_each([](const RtpProcess::Ptr &process) {
         process->onDetach();
     });
@@ -14,6 +14,7 @@
 #if defined(ENABLE_RTPPROXY)
 #include <stdint.h>
 #include <mutex>
+#include <atomic>
 #include <unordered_map>
 #include "RtpProcess.h"
 #include "Common/MediaSource.h"
@@ -72,15 +73,34 @@ public:
 
     void addStreamReplace(const std::string &stream_id, const std::string &stream_replace);
 
+    /**
+     * 获取rtp处理器个数
+     */
+    size_t size();
+
 private:
+    // 按照流id(未指定时为ssrc)哈希分片，各分片独立加锁，
+    // 大量设备复用同一端口推流时，创建、查找与超时清理互不阻塞
+    struct Shard {
+        std::mutex mtx;
+        std::unordered_map<std::string, RtpProcessHelper::Ptr> map_rtp_process;
+    };
+
+    static constexpr size_t kShardCount = 32;
+
     void onManager();
     void createTimer();
     void delStreamReplace(const std::string &stream_id);
+    std::string getOriginStreamId(const std::string &stream_id);
+    Shard &getShard(const std::string &stream_id);
 
 private:
+    std::once_flag _timer_flag;
     toolkit::Timer::Ptr _timer;
-    std::recursive_mutex _mtx_map;
-    std::unordered_map<std::string,RtpProcessHelper::Ptr> _map_rtp_process;
+    Shard _shards[kShardCount];
+    // 流id替换表很少使用，为空时查找流程跳过其加锁
+    std::atomic<size_t> _stream_replace_size { 0 };
+    std::mutex _mtx_stream_replace;
     std::unordered_map<std::string,std::string> _map_stream_replace;
 };
 
@@ -39,7 +39,7 @@ void RtpSender::startSend(const MediaSourceEvent::SendRtpArgs &args, const funct
     _args = args;
     if (!_interface) {
         //重连时不重新创建对象
-        auto lam = [this](std::shared_ptr<List<Buffer::Ptr>> list) { onFlushRtpList(std::move(list)); };
+        auto lam = [this](std::shared_ptr<PacketList<Buffer::Ptr>> list) { onFlushRtpList(std::move(list)); };
         switch (args.type) {
             case MediaSourceEvent::SendRtpArgs::kRtpPS: _interface = std::make_shared<RtpCachePS>(lam, atoi(args.ssrc.data()), args.pt, true); break;
             case MediaSourceEvent::SendRtpArgs::kRtpTS: _interface = std::make_shared<RtpCachePS>(lam, atoi(args.ssrc.data()), args.pt, false); break;
@@ -316,7 +316,7 @@ void RtpSender::onClose(const SockException &ex) {
 }
 
 //此函数在其他线程执行
-void RtpSender::onFlushRtpList(shared_ptr<List<Buffer::Ptr> > rtp_list) {
+void RtpSender::onFlushRtpList(shared_ptr<PacketList<Buffer::Ptr> > rtp_list) {
     if(!_is_connect){
         //连接成功后才能发送数据
         return;
@@ -16,6 +16,7 @@
 #include "Rtcp/RtcpContext.h"
 #include "Common/MediaSource.h"
 #include "Common/MediaSink.h"
+#include "Common/PacketCache.h"
 
 namespace mediakit{
 
@@ -67,7 +68,7 @@ public:
 
 private:
     //合并写输出
-    void onFlushRtpList(std::shared_ptr<toolkit::List<toolkit::Buffer::Ptr> > rtp_list);
+    void onFlushRtpList(std::shared_ptr<PacketList<toolkit::Buffer::Ptr> > rtp_list);
     //udp/tcp连接成功回调
     void onConnect();
     //异常断开socket事件
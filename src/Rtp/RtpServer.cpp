@@ -58,18 +58,19 @@ public:
         }
     }
 
-    void onRecvRtp(const Socket::Ptr &sock, const Buffer::Ptr &buf, struct sockaddr *addr) {
+    void onRecvRtp(const Socket::Ptr &sock, const Buffer::Ptr *buf, const struct sockaddr_storage *addr, size_t count) {
         if (!_process) {
             _process = RtpSelector::Instance().getProcess(_stream_id, true);
             _process->setOnlyTrack((RtpProcess::OnlyTrack)_only_track);
             _process->setOnDetach(std::move(_on_detach));
             cancelDelayTask();
         }
-        _process->inputRtp(true, sock, buf->data(), buf->size(), addr);
+        _process->inputRtp(sock, buf, addr, count);
 
-        // 统计rtp接受情况，用于发送rr包
-        auto header = (RtpHeader *)buf->data();
-        sendRtcp(ntohl(header->ssrc), addr);
+        // 统计rtp接受情况，用于发送rr包，一批包只需处理一次
+        auto header = (RtpHeader *)buf[count - 1]->data();
+        auto peer_addr = addr[count - 1];
+        sendRtcp(ntohl(header->ssrc), (struct sockaddr *)&peer_addr);
     }
 
     void startRtcp() {
@@ -205,19 +206,30 @@ void RtpServer::start(uint16_t local_port, const string &stream_id, TcpMode tcp_
         bool bind_peer_addr = false;
         auto ssrc_ptr = std::make_shared<uint32_t>(ssrc);
         _ssrc = ssrc_ptr;
-        rtp_socket->setOnRead([rtp_socket, helper, ssrc_ptr, bind_peer_addr](const Buffer::Ptr &buf, struct sockaddr *addr, int addr_len) mutable {
-            RtpHeader *header = (RtpHeader *)buf->data();
-            auto rtp_ssrc = ntohl(header->ssrc);
+        //ZLToolKit采用recvmmsg一次读取多个udp包到预分配的缓存中，整批交给RtpProcess处理，
+        //减少回调、查找以及rtcp统计的次数
+        rtp_socket->setOnMultiRead([rtp_socket, helper, ssrc_ptr, bind_peer_addr](Buffer::Ptr *buf, struct sockaddr_storage *addr, size_t count) mutable {
             auto ssrc = *ssrc_ptr;
-            if (ssrc && rtp_ssrc != ssrc) {
-                WarnL << "ssrc mismatched, rtp dropped: " << rtp_ssrc << " != " << ssrc;
-            } else {
-                if (!bind_peer_addr) {
-                    //绑定对方ip+端口，防止多个设备或一个设备多次推流从而日志报ssrc不匹配问题
-                    bind_peer_addr = true;
-                    rtp_socket->bindPeerAddr(addr, addr_len);
+            //连续的ssrc匹配的包作为一批输入，缓存数组归ZLToolKit所有，不能调整其顺序
+            size_t start = 0;
+            for (size_t i = 0; i <= count; ++i) {
+                if (i < count) {
+                    RtpHeader *header = (RtpHeader *)buf[i]->data();
+                    auto rtp_ssrc = ntohl(header->ssrc);
+                    if (!ssrc || rtp_ssrc == ssrc) {
+                        continue;
+                    }
+                    WarnL << "ssrc mismatched, rtp dropped: " << rtp_ssrc << " != " << ssrc;
                 }
-                helper->onRecvRtp(rtp_socket, buf, addr);
+                if (i > start) {
+                    if (!bind_peer_addr) {
+                        //绑定对方ip+端口，防止多个设备或一个设备多次推流从而日志报ssrc不匹配问题
+                        bind_peer_addr = true;
+                        rtp_socket->bindPeerAddr((struct sockaddr *)(addr + start));
+                    }
+                    helper->onRecvRtp(rtp_socket, buf + start, addr + start, i - start);
+                }
+                start = i + 1;
             }
         });
     } else {
@@ -232,7 +244,7 @@ void RtpServer::start(uint16_t local_port, const string &stream_id, TcpMode tcp_
     _on_cleanup = [rtp_socket, stream_id]() {
         if (rtp_socket) {
             //去除循环引用
-            rtp_socket->setOnRead(nullptr);
+            rtp_socket->setOnMultiRead(nullptr);
         }
     };
 
@@ -14,7 +14,8 @@ namespace mediakit{
 
 RtpPacket::Ptr RtpInfo::makeRtp(TrackType type, const void* data, size_t len, bool mark, uint64_t stamp) {
     uint16_t payload_len = (uint16_t) (len + RtpPacket::kRtpHeaderSize);
-    auto rtp = RtpPacket::create();
+    //rtp包被所有播放器以及gop缓存释放后回收，其内存大小满足要求时不会重新分配
+    auto rtp = _packet_pool_size ? _packet_pool.obtain2() : RtpPacket::create();
     rtp->setCapacity(payload_len + RtpPacket::kRtpTcpHeaderSize);
     rtp->setSize(payload_len + RtpPacket::kRtpTcpHeaderSize);
     rtp->sample_rate = _sample_rate;
@@ -14,6 +14,7 @@
 #include <memory>
 #include "Extension/Frame.h"
 #include "Util/RingBuffer.h"
+#include "Util/ResourcePool.h"
 #include "Rtsp/Rtsp.h"
 
 namespace mediakit {
@@ -64,6 +65,16 @@ public:
         _sample_rate = sample_rate;
         _interleaved = interleaved;
         _track_index = track_index;
+        setPacketPoolSize(kPacketPoolSize);
+    }
+
+    /**
+     * 设置rtp包回收池大小，为0时不复用rtp包
+     * 回收的rtp包保留其内存，后续生成同等大小的rtp包时无需再次分配
+     */
+    void setPacketPoolSize(size_t size) {
+        _packet_pool_size = size;
+        _packet_pool.setSize(size);
     }
 
     //返回rtp负载最大长度
@@ -71,9 +82,17 @@ public:
         return _mtu_size - RtpPacket::kRtpHeaderSize;
     }
 
+    /**
+     * 生成rtp包并写入rtp over tcp头与rtp头
+     * @param data 负载数据，为nullptr时不拷贝，由调用者通过getPayload()直接写入负载(如FU-A分片)
+     * @param len 负载长度
+     */
     RtpPacket::Ptr makeRtp(TrackType type,const void *data, size_t len, bool mark, uint64_t stamp);
 
 private:
+    // rtp包回收池大小，一般能覆盖gop缓存释放时一次性回收的rtp包
+    static constexpr size_t kPacketPoolSize = 1024;
+
     uint8_t _pt;
     uint8_t _interleaved;
     uint16_t _seq = 0;
@@ -81,6 +100,8 @@ private:
     uint32_t _sample_rate;
     int _track_index;
     size_t _mtu_size;
+    size_t _packet_pool_size = 0;
+    toolkit::ResourcePool<RtpPacket> _packet_pool;
 };
 
 class RtpCodec : public RtpRing, public FrameDispatcher {
@@ -94,6 +94,9 @@ void RtpMultiCaster::setDetachCB(void* listener, const onDetach& cb) {
 }
 
 RtpMultiCaster::~RtpMultiCaster() {
+    if (_pacing_task) {
+        _pacing_task->cancel();
+    }
     _rtp_reader->setReadCB(nullptr);
     _rtp_reader->setDetachCB(nullptr);
     DebugL;
@@ -105,6 +108,8 @@ RtpMultiCaster::RtpMultiCaster(SocketHelper &helper, const string &local_ip, con
         auto err = StrPrinter << "未找到媒体源:" << vhost << " " << app << " " << stream << endl;
         throw std::runtime_error(err);
     }
+    _stream_id = vhost + "/" + app + "/" + stream;
+    _poller = helper.getPoller();
     _multicast_ip = (multicast_ip) ? make_shared<uint32_t>(multicast_ip) : MultiCastAddressMaker::Instance().obtain();
     if (!_multicast_ip) {
         throw std::runtime_error("获取组播地址失败");
@@ -131,17 +136,43 @@ RtpMultiCaster::RtpMultiCaster(SocketHelper &helper, const string &local_ip, con
         peer.sin_addr.s_addr = htonl(*_multicast_ip);
         bzero(&(peer.sin_zero), sizeof peer.sin_zero);
         _udp_sock[i]->bindPeerAddr((struct sockaddr *) &peer);
+        _batch[i].setPeerAddr((struct sockaddr *) &peer);
     }
 
     src->pause(false);
     _rtp_reader = src->getRing()->attach(helper.getPoller());
     _rtp_reader->setReadCB([this](const RtspMediaSource::RingDataType &pkt) {
-        size_t i = 0;
-        auto size = pkt->size();
+        GET_CONFIG(uint32_t, pacing_kbps, MultiCast::kPacingKbps);
+        if (!pacing_kbps && _pacing_queue.empty()) {
+            //不限速，整个合并写列表一次性批量发送
+            pkt->for_each([&](const RtpPacket::Ptr &rtp) { inputRtp(rtp); });
+            flushRtp();
+            return;
+        }
         pkt->for_each([&](const RtpPacket::Ptr &rtp) {
-            auto &sock = _udp_sock[rtp->type];
-            sock->send(std::make_shared<BufferRtp>(rtp, 4), nullptr, 0, ++i == size);
+            _pacing_bytes += rtp->size();
+            _pacing_queue.emplace_back(rtp);
         });
+        if (_pacing_task) {
+            //定时器会继续发送
+            return;
+        }
+        auto delay = sendPacedRtp();
+        if (delay) {
+            //cancel()不等待正在执行的任务，所以不能捕获this
+            weak_ptr<RtpMultiCaster> weak_self = shared_from_this();
+            _pacing_task = _poller->doDelayTask(delay, [weak_self]() -> uint64_t {
+                auto strong_self = weak_self.lock();
+                if (!strong_self) {
+                    return 0;
+                }
+                auto delay = strong_self->sendPacedRtp();
+                if (!delay) {
+                    strong_self->_pacing_task = nullptr;
+                }
+                return delay;
+            });
+        }
     });
 
     _rtp_reader->setDetachCB([this]() {
@@ -161,6 +192,66 @@ RtpMultiCaster::RtpMultiCaster(SocketHelper &helper, const string &local_ip, con
            << vhost << " " << app << " " << stream;
 }
 
+void RtpMultiCaster::inputRtp(const RtpPacket::Ptr &rtp) {
+    auto &statistic = _statistic[rtp->type];
+    ++statistic.packets;
+    statistic.bytes += rtp->size() - RtpPacket::kRtpTcpHeaderSize;
+    _batch[rtp->type].input(rtp);
+}
+
+void RtpMultiCaster::flushRtp() {
+    for (auto i = 0; i < 2; ++i) {
+        auto errors = _batch[i].getErrorCount();
+        _batch[i].flush(_udp_sock[i]);
+        _statistic[i].gso_send_errors += _batch[i].getErrorCount() - errors;
+    }
+}
+
+uint64_t RtpMultiCaster::sendPacedRtp() {
+    GET_CONFIG(uint32_t, pacing_kbps, MultiCast::kPacingKbps);
+    GET_CONFIG(uint32_t, burst_kb, MultiCast::kPacingBurstKB);
+    //每毫秒可发送的字节数
+    double bytes_per_ms = pacing_kbps / 8.0;
+    double burst = MAX(burst_kb * 1024.0, 1500.0);
+    _pacing_tokens = MIN(burst, _pacing_tokens + _pacing_ticker.elapsedTime() * bytes_per_ms);
+    _pacing_ticker.resetTime();
+
+    while (!_pacing_queue.empty()) {
+        auto &rtp = _pacing_queue.front();
+        //积压超过1秒的数据说明限速低于流的码率，此时不再限速，防止无限积压
+        if (bytes_per_ms && _pacing_tokens < rtp->size() && _pacing_bytes < bytes_per_ms * 1000) {
+            break;
+        }
+        _pacing_tokens = MAX(_pacing_tokens - rtp->size(), 0.0);
+        _pacing_bytes -= rtp->size();
+        inputRtp(rtp);
+        _pacing_queue.pop_front();
+    }
+    flushRtp();
+    if (_pacing_queue.empty()) {
+        return 0;
+    }
+    //等待令牌足够发送下一个包
+    return MAX(1, (uint64_t)((_pacing_queue.front()->size() - _pacing_tokens) / bytes_per_ms));
+}
+
+const RtpMultiCaster::Statistic &RtpMultiCaster::getStatistic(TrackType trackType) const {
+    return _statistic[trackType];
+}
+
+const string &RtpMultiCaster::getStreamId() const {
+    return _stream_id;
+}
+
+void RtpMultiCaster::for_each(const function<void(const Ptr &)> &cb) {
+    lock_guard<recursive_mutex> lck(g_mtx);
+    for (auto &pr : g_multi_caster_map) {
+        if (auto caster = pr.second.lock()) {
+            cb(caster);
+        }
+    }
+}
+
 uint16_t RtpMultiCaster::getMultiCasterPort(TrackType trackType) {
     return _udp_sock[trackType]->get_local_port();
 }
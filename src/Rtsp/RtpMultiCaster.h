@@ -12,11 +12,15 @@
 #define SRC_RTSP_RTPBROADCASTER_H_
 
 #include <mutex>
+#include <deque>
+#include <atomic>
 #include <memory>
 #include <unordered_set>
 #include <unordered_map>
 #include "RtspMediaSource.h"
+#include "Util/TimeTicker.h"
 #include "Network/Socket.h"
+#include "UdpBatchSender.h"
 
 namespace mediakit{
 
@@ -38,7 +42,7 @@ private:
     std::unordered_set<uint32_t> _used_addr;
 };
 
-class RtpMultiCaster {
+class RtpMultiCaster : public std::enable_shared_from_this<RtpMultiCaster> {
 public:
     using Ptr = std::shared_ptr<RtpMultiCaster>;
     using onDetach = std::function<void()>;
@@ -51,12 +55,49 @@ public:
     std::string getMultiCasterIP();
     uint16_t getMultiCasterPort(TrackType trackType);
 
+    /**
+     * 组播组发送统计，可以跨线程读取
+     */
+    struct Statistic {
+        std::atomic<uint64_t> packets { 0 };
+        std::atomic<uint64_t> bytes { 0 };
+        // 仅统计GSO直接发送失败的次数，退化到ZLToolKit发送队列后的发送错误由其内部处理，无法统计
+        std::atomic<uint64_t> gso_send_errors { 0 };
+    };
+    const Statistic &getStatistic(TrackType trackType) const;
+
+    /**
+     * 获取流媒体标识，格式为vhost/app/stream
+     */
+    const std::string &getStreamId() const;
+
+    /**
+     * 遍历所有组播组
+     */
+    static void for_each(const std::function<void(const Ptr &)> &cb);
+
 private:
     RtpMultiCaster(toolkit::SocketHelper &helper, const std::string &local_ip, const std::string &vhost, const std::string &app, const std::string &stream, uint32_t multicast_ip, uint16_t video_port, uint16_t audio_port);
 
+    void inputRtp(const RtpPacket::Ptr &rtp);
+    void flushRtp();
+    // 按限速发送缓存的rtp，返回下次发送的延时(毫秒)，0表示发送完毕
+    uint64_t sendPacedRtp();
+
 private:
     std::recursive_mutex _mtx;
+    std::string _stream_id;
     toolkit::Socket::Ptr _udp_sock[2];
+    //批量发送器，数组下标为TrackType
+    UdpBatchSender _batch[2] { UdpBatchSender(RtpPacket::kRtpTcpHeaderSize), UdpBatchSender(RtpPacket::kRtpTcpHeaderSize) };
+    Statistic _statistic[2];
+    //限速发送
+    toolkit::EventPoller::Ptr _poller;
+    toolkit::EventPoller::DelayTask::Ptr _pacing_task;
+    toolkit::Ticker _pacing_ticker;
+    double _pacing_tokens = 0;
+    size_t _pacing_bytes = 0;
+    std::deque<RtpPacket::Ptr> _pacing_queue;
     std::shared_ptr<uint32_t> _multicast_ip;
     std::unordered_map<void * , onDetach > _detach_map;
     RtspMediaSource::RingType::RingReader::Ptr _rtp_reader;
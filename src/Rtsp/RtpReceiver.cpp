@@ -9,6 +9,7 @@
  */
 
 #include "Common/config.h"
+#include "Common/MediaSource.h"
 #include "RtpReceiver.h"
 
 namespace mediakit {
@@ -29,18 +30,18 @@ void RtpTrack::clear() {
     PacketSortor<RtpPacket::Ptr>::clear();
 }
 
-RtpPacket::Ptr RtpTrack::inputRtp(TrackType type, int sample_rate, uint8_t *ptr, size_t len) {
+bool RtpTrack::checkRtp(int sample_rate, uint8_t *ptr, size_t len) {
     if (len < RtpPacket::kRtpHeaderSize) {
         throw BadRtpException("rtp size less than 12");
     }
     GET_CONFIG(uint32_t, rtpMaxSize, Rtp::kRtpMaxSize);
     if (len > 1024 * rtpMaxSize) {
         WarnL << "超大的rtp包:" << len << " > " << 1024 * rtpMaxSize;
-        return nullptr;
+        return false;
     }
     if (!sample_rate) {
         //无法把时间戳转换成毫秒
-        return nullptr;
+        return false;
     }
     RtpHeader *header = (RtpHeader *) ptr;
     if (header->version != RtpPacket::kRtpVersion) {
@@ -58,7 +59,7 @@ RtpPacket::Ptr RtpTrack::inputRtp(TrackType type, int sample_rate, uint8_t *ptr,
         _pt = header->pt;
     } else if (header->pt != _pt) {
         //TraceL << "rtp pt mismatch:" << (int) header->pt << " !=" << (int) _pt;
-        return nullptr;
+        return false;
     }
 
     if (!_ssrc) {
@@ -73,28 +74,48 @@ RtpPacket::Ptr RtpTrack::inputRtp(TrackType type, int sample_rate, uint8_t *ptr,
         if (_ssrc_alive.elapsedTime() < 3 * 1000) {
             //接收正确ssrc的rtp在10秒内，那么我们认为存在多路rtp,忽略掉ssrc不匹配的rtp
             WarnL << "ssrc mismatch, rtp dropped:" << ssrc << " != " << _ssrc;
-            return nullptr;
+            return false;
         }
         InfoL << "rtp ssrc changed:" << _ssrc << " -> " << ssrc;
         _ssrc = ssrc;
         _ssrc_alive.resetTime();
     }
+    return true;
+}
+
+RtpPacket::Ptr RtpTrack::inputRtp(TrackType type, int sample_rate, uint8_t *ptr, size_t len) {
+    if (!checkRtp(sample_rate, ptr, len)) {
+        return nullptr;
+    }
 
     auto rtp = RtpPacket::create();
     //需要添加4个字节的rtp over tcp头
     rtp->setCapacity(RtpPacket::kRtpTcpHeaderSize + len);
     rtp->setSize(RtpPacket::kRtpTcpHeaderSize + len);
-    rtp->sample_rate = sample_rate;
-    rtp->type = type;
 
     //赋值4个字节的rtp over tcp头
     uint8_t *data = (uint8_t *) rtp->data();
     data[0] = '$';
-    data[1] = 2 * type;
     data[2] = (len >> 8) & 0xFF;
     data[3] = len & 0xFF;
     //拷贝rtp
     memcpy(&data[4], ptr, len);
+    return inputRtp_l(type, sample_rate, std::move(rtp));
+}
+
+RtpPacket::Ptr RtpTrack::inputRtp(TrackType type, int sample_rate, RtpPacket::Ptr rtp) {
+    if (rtp->size() < RtpPacket::kRtpTcpHeaderSize
+        || !checkRtp(sample_rate, (uint8_t *) rtp->data() + RtpPacket::kRtpTcpHeaderSize, rtp->size() - RtpPacket::kRtpTcpHeaderSize)) {
+        return nullptr;
+    }
+    return inputRtp_l(type, sample_rate, std::move(rtp));
+}
+
+RtpPacket::Ptr RtpTrack::inputRtp_l(TrackType type, int sample_rate, RtpPacket::Ptr rtp) {
+    rtp->sample_rate = sample_rate;
+    rtp->type = type;
+    //rtp over tcp头中的interleaved统一改为2 * type
+    rtp->data()[1] = 2 * type;
     if (_disable_ntp) {
         //不支持ntp时间戳，例如国标推流，那么直接使用rtp时间戳
         rtp->ntp_stamp = rtp->getStamp() * uint64_t(1000) / sample_rate;
@@ -118,6 +139,21 @@ void RtpTrack::setPayloadType(uint8_t pt) {
     _pt = pt;
 }
 
+void RtpTrack::enableAdaptiveJitter() {
+    GET_CONFIG(bool, adaptive, Rtp::kAdaptiveJitter);
+    enableAdaptive(adaptive);
+}
+
+void RtpTrack::getJitterBufferInfo(JitterBufferInfo &info) const {
+    info.window_size = getWindowSize();
+    info.window_ms = getWindowMS();
+    info.reorder_depth = getReorderDepth();
+    info.jitter_ms = getJitterMS();
+    info.cached = getJitterSize();
+    info.drop_count = getDropCount();
+    info.late_count = getLateCount();
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 
 void RtpTrackImp::setOnSorted(OnSorted cb) {
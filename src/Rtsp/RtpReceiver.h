@@ -11,8 +11,10 @@
 #ifndef ZLMEDIAKIT_RTPRECEIVER_H
 #define ZLMEDIAKIT_RTPRECEIVER_H
 
-#include <map>
+#include <limits>
+#include <algorithm>
 #include <string>
+#include <vector>
 #include <memory>
 #include "Rtsp/Rtsp.h"
 #include "Extension/Frame.h"
@@ -22,12 +24,20 @@
 
 namespace mediakit {
 
+struct JitterBufferInfo;
+
 template<typename T, typename SEQ = uint16_t>
 class PacketSortor {
 public:
     static constexpr SEQ SEQ_MAX = (std::numeric_limits<SEQ>::max)();
-    using iterator = typename std::map<SEQ, T>::iterator;
 
+    // 自适应时排序窗口的下限
+    static constexpr size_t kMinWindowSize = 2;
+    static constexpr size_t kMinWindowMS = 10;
+    // 乱序深度每收到该个数的包衰减一次，以便网络变好后缩小排序窗口
+    static constexpr size_t kDecayPackets = 1024;
+
+    PacketSortor() { resize(); }
     virtual ~PacketSortor() = default;
 
     void setOnSort(std::function<void(SEQ seq, T packet)> cb) { _cb = std::move(cb); }
@@ -38,13 +48,46 @@ public:
     void clear() {
         _started = false;
         _ticker.resetTime();
-        _pkt_sort_cache_map.clear();
+        clearCache();
     }
 
     /**
      * 获取排序缓存长度
      */
-    size_t getJitterSize() const { return _pkt_sort_cache_map.size(); }
+    size_t getJitterSize() const { return _size; }
+
+    /**
+     * 开启自适应排序窗口，根据实测乱序深度与网络抖动动态调整，上限为setParams设置的值；
+     * 开始的kDecayPackets个包使用固定窗口并学习乱序深度，之后干净的局域网下窗口缩小到接近0，乱序严重的链路下逐步扩大
+     */
+    void enableAdaptive(bool enable) {
+        _adaptive = enable;
+        updateWindow();
+    }
+
+    /**
+     * 设置网络抖动，一般为RtcpContextForRecv统计的到达时间抖动
+     * @param jitter_ms 抖动，单位毫秒
+     */
+    void setJitterMS(double jitter_ms) {
+        _jitter_ms = jitter_ms;
+        if (_adaptive) {
+            updateWindow();
+        }
+    }
+
+    // 当前排序窗口，单位包个数
+    size_t getWindowSize() const { return _window_size; }
+    // 当前排序最大等待时间，单位毫秒
+    size_t getWindowMS() const { return _window_ms; }
+    // 实测乱序深度，单位包个数
+    size_t getReorderDepth() const { return _reorder_depth; }
+    // 网络抖动，单位毫秒
+    double getJitterMS() const { return _jitter_ms; }
+    // 放弃等待而跳过的丢包个数
+    uint64_t getDropCount() const { return _drop_count; }
+    // 迟到而被丢弃的包个数
+    uint64_t getLateCount() const { return _late_count; }
 
     /**
      * 输入并排序
@@ -57,121 +100,212 @@ public:
             // 记录第一个seq
             _started = true;
             _last_seq_out = seq - 1;
+            _highest_seq = seq;
         }
-        auto next_seq = static_cast<SEQ>(_last_seq_out + 1);
-        if (seq == next_seq) {
+        // seq相对于下一个应该输出的seq的前向距离(考虑回环)
+        auto ahead = static_cast<SEQ>(seq - static_cast<SEQ>(_last_seq_out + 1));
+        if (!ahead) {
             // 收到下一个seq
+            if (!_size) {
+                // 顺序到达，不访问缓存
+                _highest_seq = seq;
+                output(seq, std::move(packet));
+                return;
+            }
+            // 填补了缓存前的空洞，说明发生了乱序
+            onReorder(static_cast<SEQ>(_highest_seq - seq));
             output(seq, std::move(packet));
-            // 清空连续包列表
+            // 输出缓存中的连续包
             flushPacket();
             return;
         }
 
-        if (seq < next_seq && !mayLooped(next_seq, seq)) {
-            // 无回环风险, 过滤seq回退包
+        if (ahead > SEQ_MAX >> 1) {
+            // seq回退
+            if (static_cast<SEQ>(0 - ahead) <= _max_distance) {
+                // 已经输出过或者已经放弃的包，过滤之
+                ++_late_count;
+                onReorder(static_cast<SEQ>(_highest_seq - seq));
+                return;
+            }
+            // 回退过大，说明seq发生了跳变
+            resync(seq, std::move(packet));
             return;
         }
-        _pkt_sort_cache_map.emplace(seq, std::move(packet));
 
-        if (needForceFlush(seq)) {
-            forceFlush(next_seq);
+        auto lag = static_cast<SEQ>(_highest_seq - seq);
+        if (lag > SEQ_MAX >> 1) {
+            _highest_seq = seq;
+        } else if (lag) {
+            // 比已收到的最大seq小，说明发生了乱序
+            onReorder(lag);
+        }
+
+        while (ahead > _window_size && _size) {
+            // 超出排序窗口，丢包无法恢复，放弃等待最早的丢包
+            forceFlush();
+            ahead = static_cast<SEQ>(seq - static_cast<SEQ>(_last_seq_out + 1));
+        }
+        if (ahead > _max_distance) {
+            // 前向跳跃过大，说明seq发生了跳变
+            resync(seq, std::move(packet));
+            return;
+        }
+        if (!ahead || ahead > _window_size) {
+            // 已经是下一个包，或者丢包超出排序窗口，直接输出
+            output(seq, std::move(packet));
+            flushPacket();
+            return;
+        }
+
+        auto &slot = _slots[seq & _mask];
+        if (!slot.valid) {
+            slot.valid = true;
+            slot.seq = seq;
+            slot.packet = std::move(packet);
+            ++_size;
+        }
+        // 重复包忽略之
+
+        if (_size > _max_buffer_size || _ticker.elapsedTime() > _window_ms) {
+            forceFlush();
         }
     }
 
     void flush() {
-        if (!_pkt_sort_cache_map.empty()) {
-            forceFlush(static_cast<SEQ>(_last_seq_out + 1));
-            _pkt_sort_cache_map.clear();
+        // 按顺序输出缓存中所有的包
+        while (_size) {
+            forceFlush();
         }
     }
 
     void setParams(size_t max_buffer_size, size_t max_buffer_ms, size_t max_distance) {
+        flush();
         _max_buffer_size = max_buffer_size;
         _max_buffer_ms = max_buffer_ms;
-        _max_distance = max_distance;
+        _max_distance = (std::min)(max_distance, (size_t)(SEQ_MAX >> 1));
+        resize();
+        updateWindow();
     }
 
 private:
-    SEQ distance(SEQ seq) {
-        SEQ ret;
-        auto next_seq = static_cast<SEQ>(_last_seq_out + 1);
-        if (seq > next_seq) {
-            ret = seq - next_seq;
-        } else {
-            ret = next_seq - seq;
-        }
-        if (ret > SEQ_MAX >> 1) {
-            return SEQ_MAX - ret;
-        }
-        return ret;
-    }
+    struct Slot {
+        bool valid = false;
+        SEQ seq = 0;
+        T packet;
+    };
 
-    bool needForceFlush(SEQ seq) {
-        return !_pkt_sort_cache_map.empty() && (_pkt_sort_cache_map.size() > _max_buffer_size ||
-               distance(seq) > _max_distance || _ticker.elapsedTime() > _max_buffer_ms);
+    void resize() {
+        // 环形缓存长度为2的次幂且大于最大跳跃距离，保证窗口内的seq不会冲突
+        size_t capacity = 1;
+        while (capacity <= _max_distance) {
+            capacity <<= 1;
+        }
+        _slots.clear();
+        _slots.resize(capacity);
+        _mask = capacity - 1;
+        _size = 0;
     }
 
-    //外部调用代码确保_pkt_sort_cache_map不为空
-    void forceFlush(SEQ next_seq) {
-        // 寻找距离比next_seq大的最近的seq
-        auto it = _pkt_sort_cache_map.lower_bound(next_seq);
-        if (it == _pkt_sort_cache_map.end()) {
-            // 没有比next_seq更大的seq，应该是回环时丢包导致
-            it = _pkt_sort_cache_map.begin();
+    void clearCache() {
+        if (!_size) {
+            return;
         }
-        // 丢包无法恢复，把这个包当做next_seq
-        popIterator(it);
-        // 清空连续包列表
-        flushPacket();
-        // 删除距离next_seq太大的包
-        for (auto it = _pkt_sort_cache_map.begin(); it != _pkt_sort_cache_map.end();) {
-            if (distance(it->first) > _max_distance) {
-                it = _pkt_sort_cache_map.erase(it);
-            } else {
-                ++it;
+        for (auto &slot : _slots) {
+            if (slot.valid) {
+                slot.valid = false;
+                slot.packet = T();
             }
         }
+        _size = 0;
     }
 
-    bool mayLooped(SEQ last_seq, SEQ now_seq) { return last_seq > SEQ_MAX - _max_distance || now_seq < _max_distance; }
+    // seq跳变，输出缓存中所有的包后以该包为新的起点，跳变不计为丢包
+    void resync(SEQ seq, T packet) {
+        flush();
+        _last_seq_out = seq - 1;
+        _highest_seq = seq;
+        output(seq, std::move(packet));
+    }
 
-    void flushPacket() {
-        if (_pkt_sort_cache_map.empty()) {
+    void onReorder(SEQ lag) {
+        if (lag > _reorder_depth) {
+            _reorder_depth = (std::min)((size_t)lag, _max_distance);
+            updateWindow();
+        }
+    }
+
+    void updateWindow() {
+        if (!_adaptive || _learning) {
+            _window_size = _max_distance;
+            _window_ms = _max_buffer_ms;
             return;
         }
-        auto next_seq = static_cast<SEQ>(_last_seq_out + 1);
-        auto it = _pkt_sort_cache_map.lower_bound(next_seq);
-        if (!mayLooped(next_seq, next_seq)) {
-            // 无回环风险, 清空 < next_seq的值
-            it = _pkt_sort_cache_map.erase(_pkt_sort_cache_map.begin(), it);
+        // 窗口为实测乱序深度的2倍，等待时间为抖动的4倍
+        _window_size = (std::min)((std::max)(2 * _reorder_depth, (size_t)kMinWindowSize), _max_distance);
+        _window_ms = (std::min)(kMinWindowMS + (size_t)(4 * _jitter_ms), _max_buffer_ms);
+    }
+
+    //外部调用代码确保缓存不为空
+    void forceFlush() {
+        // 寻找next_seq之后最近的包，缓存中的包都在(next_seq, next_seq + _max_distance]范围内
+        auto seq = static_cast<SEQ>(_last_seq_out + 1);
+        for (size_t i = 0; i <= _max_distance; ++i, ++seq) {
+            auto &slot = _slots[seq & _mask];
+            if (slot.valid && slot.seq == seq) {
+                // 丢包无法恢复，把这个包当做next_seq
+                pop(slot);
+                // 清空连续包列表
+                flushPacket();
+                return;
+            }
         }
+        // 不应该走到这里
+        clearCache();
+    }
 
-        while (it != _pkt_sort_cache_map.end()) {
-            // 找到下一个包
-            if (it->first == static_cast<SEQ>(_last_seq_out + 1)) {
-                it = popIterator(it);
-                continue;
+    void flushPacket() {
+        while (_size) {
+            auto seq = static_cast<SEQ>(_last_seq_out + 1);
+            auto &slot = _slots[seq & _mask];
+            if (!slot.valid || slot.seq != seq) {
+                break;
             }
-            break;
+            // 找到下一个包
+            pop(slot);
         }
     }
 
-    iterator popIterator(iterator it) {
-        output(it->first, std::move(it->second));
-        return _pkt_sort_cache_map.erase(it);
+    void pop(Slot &slot) {
+        slot.valid = false;
+        --_size;
+        output(slot.seq, std::move(slot.packet));
+        slot.packet = T();
     }
 
     void output(SEQ seq, T packet) {
         auto next_seq = static_cast<SEQ>(_last_seq_out + 1);
         if (seq != next_seq) {
+            _drop_count += static_cast<SEQ>(seq - next_seq);
             WarnL << "packet dropped: " << next_seq << " -> " << static_cast<SEQ>(seq - 1)
                   << ", latest seq: " << _latest_seq
-                  << ", jitter buffer size: " << _pkt_sort_cache_map.size()
+                  << ", jitter buffer size: " << _size
                   << ", jitter buffer ms: " << _ticker.elapsedTime();
         }
         _last_seq_out = seq;
         _cb(seq, std::move(packet));
         _ticker.resetTime();
+        if (_adaptive && ++_decay_count >= kDecayPackets) {
+            _decay_count = 0;
+            if (_learning) {
+                // 学习结束，从固定窗口缩小到实测的窗口
+                _learning = false;
+                updateWindow();
+            } else if (_reorder_depth) {
+                _reorder_depth = _reorder_depth * 3 / 4;
+                updateWindow();
+            }
+        }
     }
 
 private:
@@ -182,14 +316,34 @@ private:
     size_t _max_buffer_size = 1024;
     // seq最大跳跃距离
     size_t _max_distance = 256;
+    // 是否开启自适应排序窗口
+    bool _adaptive = false;
+    // 自适应开启后，是否还在学习乱序深度(此时使用固定窗口)
+    bool _learning = true;
+    // 当前排序窗口(包个数)与最大等待时间(毫秒)，未开启自适应时等于_max_distance与_max_buffer_ms
+    size_t _window_size = 256;
+    size_t _window_ms = 1000;
+    // 实测乱序深度
+    size_t _reorder_depth = 0;
+    size_t _decay_count = 0;
+    // 网络抖动，单位毫秒
+    double _jitter_ms = 0;
+    // 统计
+    uint64_t _drop_count = 0;
+    uint64_t _late_count = 0;
     // 记录上次output至今的时间
     toolkit::Ticker _ticker;
     // 最近输入的seq
     SEQ _latest_seq = 0;
+    // 已收到的最大seq(考虑回环)
+    SEQ _highest_seq = 0;
     // 下次应该输出的SEQ
     SEQ _last_seq_out = 0;
-    // pkt排序缓存，根据seq排序
-    std::map<SEQ, T> _pkt_sort_cache_map;
+    // pkt排序缓存，以seq为下标的环形缓存
+    std::vector<Slot> _slots;
+    size_t _mask = 0;
+    // 排序缓存中包的个数
+    size_t _size = 0;
     // 回调
     std::function<void(SEQ seq, T packet)> _cb;
 };
@@ -207,13 +361,22 @@ public:
     void clear();
     uint32_t getSSRC() const;
     RtpPacket::Ptr inputRtp(TrackType type, int sample_rate, uint8_t *ptr, size_t len);
+    // 输入已包含4个字节rtp over tcp头的rtp包，不再拷贝
+    RtpPacket::Ptr inputRtp(TrackType type, int sample_rate, RtpPacket::Ptr rtp);
     void setNtpStamp(uint32_t rtp_stamp, uint64_t ntp_stamp_ms);
     void setPayloadType(uint8_t pt);
+    // 根据配置开启自适应排序窗口
+    void enableAdaptiveJitter();
+    void getJitterBufferInfo(JitterBufferInfo &info) const;
 
 protected:
     virtual void onRtpSorted(RtpPacket::Ptr rtp) {}
     virtual void onBeforeRtpSorted(const RtpPacket::Ptr &rtp) {}
 
+private:
+    bool checkRtp(int sample_rate, uint8_t *ptr, size_t len);
+    RtpPacket::Ptr inputRtp_l(TrackType type, int sample_rate, RtpPacket::Ptr rtp);
+
 private:
     bool _disable_ntp = false;
     uint8_t _pt = 0xFF;
@@ -251,6 +414,7 @@ public:
             track.setBeforeSorted([this, index](const RtpPacket::Ptr &rtp) {
                 onBeforeRtpSorted(rtp, index);
             });
+            track.enableAdaptiveJitter();
             ++index;
         }
     }
@@ -271,6 +435,19 @@ public:
         return _track[index].inputRtp(type, sample_rate, ptr, len).operator bool();
     }
 
+    /**
+     * 输入已生成的rtp包并排序，rtp包需包含4个字节的rtp over tcp头
+     * @param index track下标索引
+     * @param type track类型
+     * @param samplerate rtp时间戳基准时钟，视频为90000，音频为采样率
+     * @param rtp rtp包
+     * @return 解析成功返回true
+     */
+    bool handleOneRtp(int index, TrackType type, int sample_rate, RtpPacket::Ptr rtp) {
+        assert(index < kCount && index >= 0);
+        return _track[index].inputRtp(type, sample_rate, std::move(rtp)).operator bool();
+    }
+
     /**
      * 设置ntp时间戳，在收到rtcp sender report时设置
      * 如果rtp_stamp/sample_rate/ntp_stamp_ms都为0，那么采用rtp时间戳为ntp时间戳
@@ -299,6 +476,21 @@ public:
         return _track[index].getJitterSize();
     }
 
+    /**
+     * 设置网络抖动，用于自适应调整排序窗口
+     * @param index track下标索引
+     * @param jitter_ms 抖动，单位毫秒
+     */
+    void setJitterMS(int index, double jitter_ms) {
+        assert(index < kCount && index >= 0);
+        _track[index].setJitterMS(jitter_ms);
+    }
+
+    void getJitterBufferInfo(int index, JitterBufferInfo &info) const {
+        assert(index < kCount && index >= 0);
+        _track[index].getJitterBufferInfo(info);
+    }
+
     uint32_t getSSRC(int index) const {
         assert(index < kCount && index >= 0);
         return _track[index].getSSRC();
@@ -13,6 +13,7 @@
 
 #include <mutex>
 #include <string>
+#include <cstring>
 #include <memory>
 #include <functional>
 #include "Common/MediaSource.h"
@@ -23,16 +24,70 @@
 
 namespace mediakit {
 
+/**
+ * rtsp合并写列表
+ * rtp包中已包含rtp over tcp的interleaved头，且rtsp播放时interleaved由服务器决定，所有tcp播放器都相同，
+ * 所以最新的列表在写入环形缓存前(写线程)序列化为一个连续的buffer，由所有rtp over tcp播放器共享，每个播放器只需send一次;
+ * 列表不再是最新时(仍可能在gop缓存中)释放该buffer，避免gop缓存占用双倍内存
+ */
+class RtpPacketList : public PacketList<RtpPacket::Ptr> {
+public:
+    /**
+     * 获取整个列表序列化后的rtp over tcp数据，播放器分布在不同的poller线程，读取不加锁
+     * @return 未生成或列表已不是最新时返回nullptr，此时应逐包发送
+     */
+    toolkit::Buffer::Ptr getTcpBuffer() const {
+        return std::atomic_load(&_tcp_buffer);
+    }
+
+    /**
+     * 写入环形缓存前在写线程调用，序列化整个列表
+     */
+    void makeTcpBuffer() {
+        size_t size = 0;
+        for (auto &rtp : *this) {
+            size += rtp->size();
+        }
+        auto buffer = toolkit::BufferRaw::create();
+        buffer->setCapacity(size + 1);
+        auto ptr = buffer->data();
+        for (auto &rtp : *this) {
+            memcpy(ptr, rtp->data(), rtp->size());
+            ptr += rtp->size();
+        }
+        buffer->setSize(size);
+        std::atomic_store(&_tcp_buffer, toolkit::Buffer::Ptr(std::move(buffer)));
+    }
+
+    /**
+     * 有更新的列表写入环形缓存后在写线程调用，释放序列化后的数据
+     */
+    void leaveLiveEdge() {
+        std::atomic_store(&_tcp_buffer, toolkit::Buffer::Ptr());
+    }
+
+    /**
+     * 列表回收时清空，同时释放序列化后的数据
+     */
+    void clear() {
+        PacketList<RtpPacket::Ptr>::clear();
+        leaveLiveEdge();
+    }
+
+private:
+    toolkit::Buffer::Ptr _tcp_buffer;
+};
+
 /**
  * rtsp媒体源的数据抽象
  * rtsp有关键的两要素，分别是sdp、rtp包
  * 只要生成了这两要素，那么要实现rtsp推流、rtsp服务器就很简单了
  * rtsp推拉流协议中，先传递sdp，然后再协商传输方式(tcp/udp/组播)，最后一直传递rtp
  */
-class RtspMediaSource : public MediaSource, public toolkit::RingDelegate<RtpPacket::Ptr>, private PacketCache<RtpPacket> {
+class RtspMediaSource : public MediaSource, public toolkit::RingDelegate<RtpPacket::Ptr>, private PacketCache<RtpPacket, FlushPolicy, RtpPacketList> {
 public:
     using Ptr = std::shared_ptr<RtspMediaSource>;
-    using RingDataType = std::shared_ptr<toolkit::List<RtpPacket::Ptr> >;
+    using RingDataType = std::shared_ptr<RtpPacketList>;
     using RingType = toolkit::RingBuffer<RingDataType>;
 
     /**
@@ -130,7 +185,7 @@ public:
     void onWrite(RtpPacket::Ptr rtp, bool keyPos) override;
 
     void clearCache() override{
-        PacketCache<RtpPacket>::clearCache();
+        PacketCache<RtpPacket, FlushPolicy, RtpPacketList>::clearCache();
         _ring->clearCache();
     }
 
@@ -140,13 +195,25 @@ private:
      * @param rtp_list rtp包列表
      * @param key_pos 是否包含关键帧
      */
-    void onFlush(std::shared_ptr<toolkit::List<RtpPacket::Ptr> > rtp_list, bool key_pos) override {
+    void onFlush(std::shared_ptr<RtpPacketList> rtp_list, bool key_pos) override {
         //如果不存在视频，那么就没有存在GOP缓存的意义，所以is_key一直为true确保一直清空GOP缓存
-        _ring->write(std::move(rtp_list), _have_video ? key_pos : true);
+        key_pos = _have_video ? key_pos : true;
+        rtp_list->key_pos = key_pos;
+        //上一个列表只可能留在gop缓存中或被落后的播放器发送，释放其序列化数据
+        if (auto last_list = _last_list.lock()) {
+            last_list->leaveLiveEdge();
+        }
+        if (readerCount()) {
+            //有人观看时才序列化最新列表
+            rtp_list->makeTcpBuffer();
+        }
+        _last_list = rtp_list;
+        _ring->write(std::move(rtp_list), key_pos);
     }
 
 private:
     bool _have_video = false;
+    std::weak_ptr<RtpPacketList> _last_list;
     int _ring_size;
     std::string _sdp;
     RingType::Ptr _ring;
@@ -71,7 +71,7 @@ void RtspMediaSource::onWrite(RtpPacket::Ptr rtp, bool keyPos) {
         }
     }
     bool is_video = rtp->type == TrackVideo;
-    PacketCache<RtpPacket>::inputPacket(stamp, is_video, std::move(rtp), keyPos);
+    PacketCache<RtpPacket, FlushPolicy, RtpPacketList>::inputPacket(stamp, is_video, std::move(rtp), keyPos);
 }
 
 RtspMediaSourceImp::RtspMediaSourceImp(const MediaTuple& tuple, int ringSize): RtspMediaSource(tuple, ringSize)
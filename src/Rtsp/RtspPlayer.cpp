@@ -521,6 +521,19 @@ void RtspPlayer::onRtpPacket(const char *data, size_t len) {
     }
 }
 
+void RtspPlayer::onWholeRtpPacket(const RtpPacket::Ptr &rtp) {
+    uint8_t interleaved = rtp->data()[1];
+    if (interleaved % 2 != 0) {
+        onRtpPacket(rtp->data(), rtp->size());
+        return;
+    }
+    auto trackIdx = getTrackIndexByInterleaved(interleaved);
+    if (trackIdx == -1) {
+        return;
+    }
+    handleOneRtp(trackIdx, _sdp_track[trackIdx]->_type, _sdp_track[trackIdx]->_samplerate, rtp);
+}
+
 // 此处预留rtcp处理函数
 void RtspPlayer::onRtcpPacket(int track_idx, SdpTrack::Ptr &track, uint8_t *data, size_t len) {
     auto rtcp_arr = RtcpHeader::loadFromBytes((char *)data, len);
@@ -639,6 +652,8 @@ void RtspPlayer::sendRtspRequest(const string &cmd, const string &url, const Str
 void RtspPlayer::onBeforeRtpSorted(const RtpPacket::Ptr &rtp, int track_idx) {
     auto &rtcp_ctx = _rtcp_context[track_idx];
     rtcp_ctx->onRtp(rtp->getSeq(), rtp->getStamp(), rtp->ntp_stamp, rtp->sample_rate, rtp->size() - RtpPacket::kRtpTcpHeaderSize);
+    //根据rtcp统计的网络抖动调整排序窗口
+    setJitterMS(track_idx, rtcp_ctx->getJitterMS());
 
     auto &ticker = _rtcp_send_ticker[track_idx];
     if (ticker.elapsedTime() < 3 * 1000) {
@@ -742,6 +757,15 @@ int RtspPlayer::getTrackIndexByInterleaved(int interleaved) const {
     return -1;
 }
 
+bool RtspPlayer::getJitterBufferInfo(TrackType type, JitterBufferInfo &info) const {
+    try {
+        RtpReceiver::getJitterBufferInfo(getTrackIndexByTrackType(type), info);
+        return true;
+    } catch (...) {
+        return false;
+    }
+}
+
 int RtspPlayer::getTrackIndexByTrackType(TrackType track_type) const {
     for (size_t i = 0; i < _sdp_track.size(); ++i) {
         if (_sdp_track[i]->_type == track_type) {
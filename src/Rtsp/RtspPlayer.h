@@ -37,6 +37,7 @@ public:
     void speed(float speed) override;
     void teardown() override;
     float getPacketLossRate(TrackType type) const override;
+    bool getJitterBufferInfo(TrackType type, JitterBufferInfo &info) const override;
 
 protected:
     //派生类回调函数
@@ -58,6 +59,12 @@ protected:
      */
     void onRtpPacket(const char *data,size_t len) override ;
 
+    /**
+     * 收到跨越多次接收、已拼接完整的rtp包回调
+     * @param rtp rtp包
+     */
+    void onWholeRtpPacket(const RtpPacket::Ptr &rtp) override;
+
     /**
      * rtp数据包排序后输出
      * @param rtp rtp数据包
@@ -69,6 +69,11 @@ void RtspSession::onError(const SockException &err) {
         UDPServer::Instance().stopListenPeer(get_peer_ip().data(), this);
     }
 
+    if (_udp_shared) {
+        //取消共享udp端口监听
+        UDPServer::Instance().stopListenSharedTrack(this);
+    }
+
     if (_http_x_sessioncookie.size() != 0) {
         //移除http getter的弱引用记录
         lock_guard<recursive_mutex> lock(g_mtxGetter);
@@ -174,6 +179,18 @@ void RtspSession::onRtpPacket(const char *data, size_t len) {
     }
 }
 
+void RtspSession::onWholeRtpPacket(const RtpPacket::Ptr &rtp) {
+    uint8_t interleaved = rtp->data()[1];
+    if (interleaved % 2 != 0) {
+        //rtcp包
+        onRtpPacket(rtp->data(), rtp->size());
+        return;
+    }
+    //直接复用已拼接好的rtp包，免去再次拷贝
+    auto track_idx = getTrackIndexByInterleaved(interleaved);
+    handleOneRtp(track_idx, _sdp_track[track_idx]->_type, _sdp_track[track_idx]->_samplerate, rtp);
+}
+
 void RtspSession::onRtcpPacket(int track_idx, SdpTrack::Ptr &track, const char *data, size_t len){
     auto rtcp_arr = RtcpHeader::loadFromBytes((char *) data, len);
     for (auto &rtcp : rtcp_arr) {
@@ -702,13 +719,18 @@ void RtspSession::handleReq_Setup(const Parser &parser) {
         break;
 
     case Rtsp::RTP_UDP: {
-        std::pair<Socket::Ptr, Socket::Ptr> pr = std::make_pair(createSocket(),createSocket());
-        try {
-            makeSockPair(pr, get_local_ip());
-        } catch (std::exception &ex) {
-            //分配端口失败
-            send_NotAcceptable();
-            throw SockException(Err_shutdown, ex.what());
+        //开启共享端口时使用本poller的共享socket，否则每个track分配一对端口
+        auto pr = UDPServer::Instance().getSharedSock(getPoller());
+        _udp_shared = (bool)pr.first;
+        if (!_udp_shared) {
+            pr = std::make_pair(createSocket(), createSocket());
+            try {
+                makeSockPair(pr, get_local_ip());
+            } catch (std::exception &ex) {
+                //分配端口失败
+                send_NotAcceptable();
+                throw SockException(Err_shutdown, ex.what());
+            }
         }
 
         _rtp_socks[trackIdx] = pr.first;
@@ -719,13 +741,23 @@ void RtspSession::handleReq_Setup(const Parser &parser) {
         uint16_t ui16RtpPort = atoi(findSubString(strClientPort.data(), NULL, "-").data());
         uint16_t ui16RtcpPort = atoi(findSubString(strClientPort.data(), "-", NULL).data());
 
-        auto peerAddr = SockUtil::make_sockaddr(get_peer_ip().data(), ui16RtpPort);
+        _rtp_peer_addr[trackIdx] = SockUtil::make_sockaddr(get_peer_ip().data(), ui16RtpPort);
+        _rtcp_peer_addr[trackIdx] = SockUtil::make_sockaddr(get_peer_ip().data(), ui16RtcpPort);
         //设置rtp发送目标地址
-        pr.first->bindPeerAddr((struct sockaddr *) (&peerAddr), 0, true);
+        _rtp_batch[trackIdx].setPeerAddr((struct sockaddr *) (&_rtp_peer_addr[trackIdx]));
+        if (!_udp_shared) {
+            pr.first->bindPeerAddr((struct sockaddr *) (&_rtp_peer_addr[trackIdx]), 0, true);
+            //设置rtcp发送目标地址
+            pr.second->bindPeerAddr((struct sockaddr *) (&_rtcp_peer_addr[trackIdx]), 0, true);
+        }
 
-        //设置rtcp发送目标地址
-        peerAddr = SockUtil::make_sockaddr(get_peer_ip().data(), ui16RtcpPort);
-        pr.second->bindPeerAddr((struct sockaddr *) (&peerAddr), 0, true);
+        if (_push_src) {
+            //推流者在Transport中声明的ssrc，共享端口时用于区分track
+            auto key_values = Parser::parseArgs(parser["Transport"], ";", "=");
+            if (!key_values["ssrc"].empty()) {
+                trackRef->_ssrc = (uint32_t)strtoul(key_values["ssrc"].data(), nullptr, 16);
+            }
+        }
 
         //尝试获取客户端nat映射地址
         startListenPeerUdpData(trackIdx);
@@ -986,7 +1018,11 @@ void RtspSession::onRcvPeerUdpData(int interleaved, const Buffer::Ptr &buf, cons
             //这是rtsp播放器的rtp打洞包
             _udp_connected_flags.emplace(interleaved);
             if (_rtp_socks[interleaved / 2]) {
-                _rtp_socks[interleaved / 2]->bindPeerAddr((struct sockaddr *)&addr);
+                if (!_udp_shared) {
+                    _rtp_socks[interleaved / 2]->bindPeerAddr((struct sockaddr *)&addr);
+                }
+                _rtp_peer_addr[interleaved / 2] = addr;
+                _rtp_batch[interleaved / 2].setPeerAddr((struct sockaddr *)&addr);
             }
         }
     } else {
@@ -994,7 +1030,10 @@ void RtspSession::onRcvPeerUdpData(int interleaved, const Buffer::Ptr &buf, cons
         if (!_udp_connected_flags.count(interleaved)) {
             _udp_connected_flags.emplace(interleaved);
             if (_rtcp_socks[(interleaved - 1) / 2]) {
-                _rtcp_socks[(interleaved - 1) / 2]->bindPeerAddr((struct sockaddr *)&addr);
+                if (!_udp_shared) {
+                    _rtcp_socks[(interleaved - 1) / 2]->bindPeerAddr((struct sockaddr *)&addr);
+                }
+                _rtcp_peer_addr[(interleaved - 1) / 2] = addr;
             }
         }
         onRtcpPacket((interleaved - 1) / 2, _sdp_track[(interleaved - 1) / 2], buf->data(), buf->size());
@@ -1043,6 +1082,15 @@ void RtspSession::startListenPeerUdpData(int track_idx) {
         }
             break;
         case Rtsp::RTP_UDP:{
+            if (_udp_shared) {
+                //共享端口根据对端地址以及ssrc区分track，推流时ssrc未知则从首个rtp包学习
+                UDPServer::Instance().listenSharedTrack(this, 2 * track_idx, (struct sockaddr *)&_rtp_peer_addr[track_idx],
+                    (struct sockaddr *)&_rtcp_peer_addr[track_idx], _sdp_track[track_idx]->_ssrc,
+                    [onUdpData](int interleaved, const Buffer::Ptr &buf, struct sockaddr *peer_addr) {
+                    return onUdpData(buf, peer_addr, interleaved);
+                });
+                break;
+            }
             auto setEvent = [&](Socket::Ptr &sock,int interleaved){
                 if(!sock){
                     WarnP(this) << "udp端口为空:" << interleaved;
@@ -1187,6 +1235,17 @@ toolkit::EventPoller::Ptr RtspSession::getOwnerPoller(MediaSource &sender) {
 
 void RtspSession::onBeforeRtpSorted(const RtpPacket::Ptr &rtp, int track_index){
     updateRtcpContext(rtp);
+    //根据rtcp统计的网络抖动调整排序窗口
+    setJitterMS(track_index, _rtcp_context[track_index]->getJitterMS());
+}
+
+bool RtspSession::getJitterBufferInfo(MediaSource &sender, TrackType type, JitterBufferInfo &info) {
+    try {
+        RtpReceiver::getJitterBufferInfo(getTrackIndexByTrackType(type), info);
+        return true;
+    } catch (...) {
+        return false;
+    }
 }
 
 void RtspSession::updateRtcpContext(const RtpPacket::Ptr &rtp){
@@ -1211,7 +1270,10 @@ void RtspSession::updateRtcpContext(const RtpPacket::Ptr &rtp){
                 thiz->send(makeRtpOverTcpPrefix((uint16_t)(ptr->size()), track->_interleaved + 1));
                 thiz->send(std::move(ptr));
             } else {
-                thiz->_rtcp_socks[index]->send(std::move(ptr));
+                //共享端口的socket未绑定对端地址，需指定rtcp发送地址
+                auto addr = thiz->_udp_shared ? (struct sockaddr *)&thiz->_rtcp_peer_addr[index] : nullptr;
+                auto addr_len = addr ? (addr->sa_family == AF_INET ? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6)) : 0;
+                thiz->_rtcp_socks[index]->send(std::move(ptr), addr, addr_len);
             }
         };
 
@@ -1228,22 +1290,47 @@ void RtspSession::updateRtcpContext(const RtpPacket::Ptr &rtp){
 void RtspSession::sendRtpPacket(const RtspMediaSource::RingDataType &pkt) {
     switch (_rtp_type) {
         case Rtsp::RTP_TCP: {
+            auto action = _back_pressure.check(*this, pkt);
+            if (action == BackPressure::kActionDisconnect) {
+                shutdown(SockException(Err_shutdown, "rtsp player send queue overflow"));
+                return;
+            }
+            if (action == BackPressure::kActionDrop) {
+                return;
+            }
+            //音视频都播放且不丢帧时，直接发送共享的预先序列化数据，否则(或列表已不是最新)逐包过滤发送
+            Buffer::Ptr tcp_buffer;
+            if (action == BackPressure::kActionSend && _target_play_track == TrackInvalid) {
+                tcp_buffer = pkt->getTcpBuffer();
+            }
             setSendFlushFlag(false);
             pkt->for_each([&](const RtpPacket::Ptr &rtp) {
                 if (_target_play_track == TrackInvalid || _target_play_track == rtp->type) {
+                    if (action == BackPressure::kActionSendAudio && rtp->type == TrackVideo) {
+                        _back_pressure.onDropVideo(rtp->size());
+                        return;
+                    }
                     updateRtcpContext(rtp);
-                    send(rtp);
+                    if (!tcp_buffer) {
+                        send(rtp);
+                    }
                 }
             });
+            if (tcp_buffer) {
+                send(std::move(tcp_buffer));
+            }
             flushAll();
             setSendFlushFlag(true);
         }
             break;
         case Rtsp::RTP_UDP: {
             //下标0表示视频，1表示音频
+            int track_idx[2];
+            track_idx[TrackVideo] = getTrackIndexByTrackType(TrackVideo);
+            track_idx[TrackAudio] = getTrackIndexByTrackType(TrackAudio);
             Socket::Ptr rtp_socks[2];
-            rtp_socks[TrackVideo] = _rtp_socks[getTrackIndexByTrackType(TrackVideo)];
-            rtp_socks[TrackAudio] = _rtp_socks[getTrackIndexByTrackType(TrackAudio)];
+            rtp_socks[TrackVideo] = _rtp_socks[track_idx[TrackVideo]];
+            rtp_socks[TrackAudio] = _rtp_socks[track_idx[TrackAudio]];
             pkt->for_each([&](const RtpPacket::Ptr &rtp) {
                 if (_target_play_track == TrackInvalid || _target_play_track == rtp->type) {
                     updateRtcpContext(rtp);
@@ -1253,12 +1340,13 @@ void RtspSession::sendRtpPacket(const RtspMediaSource::RingDataType &pkt) {
                         return;
                     }
                     _bytes_usage += rtp->size() - RtpPacket::kRtpTcpHeaderSize;
-                    sock->send(std::make_shared<BufferRtp>(rtp, RtpPacket::kRtpTcpHeaderSize), nullptr, 0, false);
+                    //整个合并写列表缓存后一次性批量发送，减少系统调用次数
+                    _rtp_batch[track_idx[rtp->type]].input(rtp);
                 }
             });
-            for (auto &sock : rtp_socks) {
+            for (auto &sock : _rtp_socks) {
                 if (sock) {
-                    sock->flushAll();
+                    _rtp_batch[&sock - _rtp_socks].flush(sock);
                 }
             }
         }
@@ -21,11 +21,13 @@
 #include "RtspMediaSource.h"
 #include "RtspMediaSourceImp.h"
 #include "RtpMultiCaster.h"
+#include "Common/BackPressure.h"
+#include "UdpBatchSender.h"
 
 namespace mediakit {
 
 using BufferRtp = toolkit::BufferOffset<toolkit::Buffer::Ptr>;
-class RtspSession : public toolkit::Session, public RtspSplitter, public RtpReceiver, public MediaSourceEvent {
+class RtspSession : public toolkit::Session, public RtspSplitter, public RtpReceiver, public MediaSourceEvent, public BackPressureSession {
 public:
     using Ptr = std::shared_ptr<RtspSession>;
     using onGetRealm = std::function<void(const std::string &realm)>;
@@ -38,6 +40,8 @@ public:
     void onRecv(const toolkit::Buffer::Ptr &buf) override;
     void onError(const toolkit::SockException &err) override;
     void onManager() override;
+    ////BackPressureSession override////
+    const BackPressure &getBackPressure() const override { return _back_pressure; }
 
 protected:
     /////RtspSplitter override/////
@@ -45,6 +49,8 @@ protected:
     void onWholeRtspPacket(Parser &parser) override;
     //收到rtp包回调
     void onRtpPacket(const char *data, size_t len) override;
+    //收到跨越多次接收的完整rtp包回调
+    void onWholeRtpPacket(const RtpPacket::Ptr &rtp) override;
     //从rtsp头中获取Content长度
     ssize_t getContentLength(Parser &parser) override;
 
@@ -65,6 +71,8 @@ protected:
     std::shared_ptr<SockInfo> getOriginSock(MediaSource &sender) const override;
     // 由于支持断连续推，存在OwnerPoller变更的可能
     toolkit::EventPoller::Ptr getOwnerPoller(MediaSource &sender) override;
+    // 获取rtp排序缓存状态
+    bool getJitterBufferInfo(MediaSource &sender, TrackType type, JitterBufferInfo &info) override;
 
     /////Session override////
     ssize_t send(toolkit::Buffer::Ptr pkt) override;
@@ -180,6 +188,8 @@ private:
     std::weak_ptr<RtspMediaSource> _play_src;
     //直播源读取器
     RtspMediaSource::RingType::RingReader::Ptr _play_reader;
+    //rtp over tcp播放时的发送队列背压控制
+    BackPressure _back_pressure;
     //sdp里面有效的track,包含音频或视频
     std::vector<SdpTrack::Ptr> _sdp_track;
     //播放器setup指定的播放track,默认为TrackInvalid表示不指定即音视频都推
@@ -188,10 +198,17 @@ private:
     ////////RTP over udp////////
     //RTP端口,trackid idx 为数组下标
     toolkit::Socket::Ptr _rtp_socks[2];
+    //RTP批量发送器,trackid idx 为数组下标
+    UdpBatchSender _rtp_batch[2] { UdpBatchSender(RtpPacket::kRtpTcpHeaderSize), UdpBatchSender(RtpPacket::kRtpTcpHeaderSize) };
     //RTCP端口,trackid idx 为数组下标
     toolkit::Socket::Ptr _rtcp_socks[2];
     //标记是否收到播放的udp打洞包,收到播放的udp打洞包后才能知道其外网udp端口号
     std::unordered_set<int> _udp_connected_flags;
+    //是否使用共享udp端口(rtsp.udpSharedPort)，共享socket不能bindPeerAddr，发送时需指定对端地址
+    bool _udp_shared = false;
+    //对端rtp/rtcp地址,trackid idx 为数组下标
+    struct sockaddr_storage _rtp_peer_addr[2];
+    struct sockaddr_storage _rtcp_peer_addr[2];
     ////////RTSP over HTTP  ////////
     //quicktime 请求rtsp会产生两次tcp连接，
     //一次发送 get 一次发送post，需要通过x-sessioncookie关联起来
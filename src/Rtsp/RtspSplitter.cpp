@@ -9,6 +9,7 @@
  */
 
 #include <cstdlib>
+#include <cstring>
 #include "RtspSplitter.h"
 #include "Util/logger.h"
 #include "Util/util.h"
@@ -18,6 +19,33 @@ using namespace toolkit;
 
 namespace mediakit{
 
+void RtspSplitter::input(const char *data, size_t len) {
+    if (_rtp_pending) {
+        //继续填充上次未接收完整的rtp包
+        auto size = MIN(len, _rtp_pending->size() - _rtp_pending_offset);
+        memcpy(_rtp_pending->data() + _rtp_pending_offset, data, size);
+        _rtp_pending_offset += size;
+        data += size;
+        len -= size;
+        if (_rtp_pending_offset < _rtp_pending->size()) {
+            //数据不够
+            return;
+        }
+        auto rtp = std::move(_rtp_pending);
+        _rtp_pending_offset = 0;
+        onWholeRtpPacket(rtp);
+    }
+    if (len) {
+        HttpRequestSplitter::input(data, len);
+    }
+}
+
+void RtspSplitter::reset() {
+    HttpRequestSplitter::reset();
+    _rtp_pending = nullptr;
+    _rtp_pending_offset = 0;
+}
+
 const char *RtspSplitter::onSearchPacketTail(const char *data, size_t len) {
     auto ret = onSearchPacketTail_l(data, len);
     if(ret){
@@ -47,17 +75,29 @@ const char *RtspSplitter::onSearchPacketTail_l(const char *data, size_t len) {
         return nullptr;
     }
     uint16_t length = (((uint8_t *)data)[2] << 8) | ((uint8_t *)data)[3];
+    _isRtpPacket = true;
     if(len < (size_t)(length + 4)){
-        //数据不够
-        return nullptr;
+        //rtp包跨越了多次接收，消费掉已收到的数据并在onRecvHeader中开始拼接，
+        //避免先缓存到_remain_data再拷贝到rtp包
+        return data + len;
     }
     //返回rtp包末尾
-    _isRtpPacket = true;
     return data + 4 + length;
 }
 
 ssize_t RtspSplitter::onRecvHeader(const char *data, size_t len) {
     if (_isRtpPacket) {
+        size_t total = RtpPacket::kRtpTcpHeaderSize + ((((uint8_t *)data)[2] << 8) | ((uint8_t *)data)[3]);
+        if (len < total) {
+            //按照完整长度分配rtp包，后续数据直接填充到其中，每个字节只拷贝一次
+            _rtp_pending = RtpPacket::create();
+            _rtp_pending->setCapacity(total);
+            _rtp_pending->setSize(total);
+            memcpy(_rtp_pending->data(), data, len);
+            _rtp_pending_offset = len;
+            return 0;
+        }
+        //rtp包完整的位于本次接收的数据中
         onRtpPacket(data, len);
         return 0;
     }
@@ -79,6 +119,10 @@ void RtspSplitter::onRecvContent(const char *data, size_t len) {
     _parser.clear();
 }
 
+void RtspSplitter::onWholeRtpPacket(const RtpPacket::Ptr &rtp) {
+    onRtpPacket(rtp->data(), rtp->size());
+}
+
 void RtspSplitter::enableRecvRtp(bool enable) {
     _enableRecvRtp = enable;
 }
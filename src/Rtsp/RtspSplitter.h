@@ -13,6 +13,7 @@
 
 #include "Common/Parser.h"
 #include "Http/HttpRequestSplitter.h"
+#include "Rtsp.h"
 
 namespace mediakit{
 
@@ -23,6 +24,17 @@ public:
     * @param enable
     */
     void enableRecvRtp(bool enable);
+
+    /**
+     * 添加数据，优先填充跨越多次接收的rtp包
+     */
+    void input(const char *data, size_t len) override;
+
+    /**
+     * 恢复初始设置，同时丢弃未拼接完整的rtp包
+     */
+    void reset() override;
+
 protected:
     /**
      * 收到完整的rtsp包回调，包括sdp等content数据
@@ -37,6 +49,14 @@ protected:
      */
     virtual void onRtpPacket(const char *data,size_t len) = 0;
 
+    /**
+     * 收到跨越多次接收、已拼接完整的rtp包回调
+     * 数据包含4个字节的rtp over tcp头，可以直接作为rtp包使用，免去再次拷贝
+     * 默认按照onRtpPacket(const char *data,size_t len)处理
+     * @param rtp rtp包
+     */
+    virtual void onWholeRtpPacket(const RtpPacket::Ptr &rtp);
+
     /**
      * 从rtsp头中获取Content长度
      * @param parser
@@ -53,6 +73,10 @@ protected:
 private:
     bool _enableRecvRtp = false;
     bool _isRtpPacket = false;
+    //未接收完整的rtp包已填充的长度
+    size_t _rtp_pending_offset = 0;
+    //跨越多次接收的rtp包，按照完整长度预先分配
+    RtpPacket::Ptr _rtp_pending;
     Parser _parser;
 };
 
@@ -9,8 +9,10 @@
  */
 
 #include "UDPServer.h"
+#include <algorithm>
 #include "Util/TimeTicker.h"
 #include "Util/onceToken.h"
+#include "Common/config.h"
 
 using namespace toolkit;
 using namespace std;
@@ -95,6 +97,191 @@ void UDPServer::onRecv(int interleaved, const Buffer::Ptr &buf, struct sockaddr*
     }
 }
 
+//////////////////////////////////////////////////共享端口模式//////////////////////////////////////////////////
+
+UDPServer::SharedKey UDPServer::makeSharedKey(const struct sockaddr *addr, uint32_t tail) {
+    SharedKey key;
+    memset(key.addr, 0, sizeof(key.addr));
+    key.tail = tail;
+    if (addr->sa_family == AF_INET6) {
+        memcpy(key.addr, &((struct sockaddr_in6 *)addr)->sin6_addr, 16);
+    } else {
+        key.addr[10] = key.addr[11] = 0xFF;
+        memcpy(key.addr + 12, &((struct sockaddr_in *)addr)->sin_addr, 4);
+    }
+    return key;
+}
+
+UDPServer::SharedKey UDPServer::makePeerKey(const struct sockaddr *addr) {
+    auto port = addr->sa_family == AF_INET6 ? ((struct sockaddr_in6 *)addr)->sin6_port : ((struct sockaddr_in *)addr)->sin_port;
+    return makeSharedKey(addr, port);
+}
+
+UDPServer::SharedKey UDPServer::makeSSRCKey(const struct sockaddr *addr, uint32_t ssrc) {
+    return makeSharedKey(addr, ssrc);
+}
+
+pair<Socket::Ptr, Socket::Ptr> UDPServer::getSharedSock(const EventPoller::Ptr &poller) {
+    GET_CONFIG(uint16_t, shared_port, Rtsp::kUdpSharedPort);
+    if (!shared_port) {
+        return make_pair(nullptr, nullptr);
+    }
+    lock_guard<mutex> lck(_mtx_udp_sock);
+    if (_shared_sock_map.empty()) {
+        //每个poller绑定一对SO_REUSEPORT socket，由内核根据四元组哈希分摊到各poller接收
+        EventPollerPool::Instance().for_each([&](const TaskExecutor::Ptr &executor) {
+            auto sock_poller = static_pointer_cast<EventPoller>(executor);
+            auto rtp_sock = Socket::createSocket(sock_poller, true);
+            auto rtcp_sock = Socket::createSocket(sock_poller, true);
+            if (!rtp_sock->bindUdpSock(shared_port, "::", true) || !rtcp_sock->bindUdpSock(shared_port + 1, "::", true)) {
+                WarnL << "绑定rtp over udp共享端口失败:" << shared_port;
+                return;
+            }
+            rtp_sock->setOnRead([this](const Buffer::Ptr &buf, struct sockaddr *addr, int) { onRecvShared(false, buf, addr); });
+            rtcp_sock->setOnRead([this](const Buffer::Ptr &buf, struct sockaddr *addr, int) { onRecvShared(true, buf, addr); });
+            _shared_sock_map.emplace(sock_poller.get(), make_pair(rtp_sock, rtcp_sock));
+        });
+        InfoL << "rtp over udp共享端口:" << shared_port << "-" << shared_port + 1 << ", socket对数:" << _shared_sock_map.size();
+    }
+    auto it = _shared_sock_map.find(poller.get());
+    if (it == _shared_sock_map.end()) {
+        return make_pair(nullptr, nullptr);
+    }
+    return it->second;
+}
+
+void UDPServer::listenSharedTrack(void *obj, int interleaved, const struct sockaddr *rtp_peer, const struct sockaddr *rtcp_peer, uint32_t ssrc, const onRecvData &cb) {
+    auto track = std::make_shared<SharedTrack>();
+    track->obj = obj;
+    track->interleaved = interleaved;
+    track->cb = cb;
+
+    lock_guard<mutex> lck(_mtx_shared_track);
+    _shared_track_map[obj].emplace_back(track);
+    addSharedPeer(track, makePeerKey(rtp_peer));
+    addSharedPeer(track, makePeerKey(rtcp_peer));
+    if (ssrc) {
+        addSharedSSRC(track, makeSSRCKey(rtp_peer, ssrc));
+    }
+}
+
+void UDPServer::stopListenSharedTrack(void *obj) {
+    lock_guard<mutex> lck(_mtx_shared_track);
+    auto it = _shared_track_map.find(obj);
+    if (it == _shared_track_map.end()) {
+        return;
+    }
+    for (auto &track : it->second) {
+        track->removed = true;
+        for (auto &peer : track->peers) {
+            auto &shard = getShard(peer);
+            lock_guard<mutex> lck(shard.mtx);
+            auto it_peer = shard.peer_map.find(peer);
+            //该地址可能已经被其他track重新注册
+            if (it_peer != shard.peer_map.end() && it_peer->second == track) {
+                shard.peer_map.erase(it_peer);
+            }
+        }
+        for (auto &key : track->ssrcs) {
+            auto &shard = getShard(key);
+            lock_guard<mutex> lck(shard.mtx);
+            auto it_ssrc = shard.ssrc_map.find(key);
+            if (it_ssrc == shard.ssrc_map.end()) {
+                continue;
+            }
+            auto &tracks = it_ssrc->second;
+            tracks.erase(std::remove(tracks.begin(), tracks.end(), track), tracks.end());
+            if (tracks.empty()) {
+                shard.ssrc_map.erase(it_ssrc);
+            }
+        }
+    }
+    _shared_track_map.erase(it);
+}
+
+void UDPServer::addSharedPeer(const SharedTrack::Ptr &track, const SharedKey &peer) {
+    //调用者需持有_mtx_shared_track
+    auto &shard = getShard(peer);
+    lock_guard<mutex> lck(shard.mtx);
+    shard.peer_map[peer] = track;
+    track->peers.emplace_back(peer);
+}
+
+void UDPServer::addSharedSSRC(const SharedTrack::Ptr &track, const SharedKey &ssrc_key) {
+    //调用者需持有_mtx_shared_track
+    auto &shard = getShard(ssrc_key);
+    lock_guard<mutex> lck(shard.mtx);
+    shard.ssrc_map[ssrc_key].emplace_back(track);
+    track->ssrcs.emplace_back(ssrc_key);
+    track->has_ssrc = true;
+}
+
+void UDPServer::onRecvShared(bool is_rtcp, const Buffer::Ptr &buf, struct sockaddr *peer_addr) {
+    auto peer = makePeerKey(peer_addr);
+    SharedTrack::Ptr track;
+    {
+        auto &shard = getShard(peer);
+        lock_guard<mutex> lck(shard.mtx);
+        auto it = shard.peer_map.find(peer);
+        if (it != shard.peer_map.end()) {
+            track = it->second;
+        }
+    }
+
+    //快速路径：对端地址已注册且无需学习ssrc时，不再解析ssrc
+    if (track && (is_rtcp || track->has_ssrc)) {
+        if (!track->cb(track->interleaved + (is_rtcp ? 1 : 0), buf, peer_addr)) {
+            stopListenSharedTrack(track->obj);
+        }
+        return;
+    }
+
+    //rtp包的ssrc位于第8~11字节；rtcp sr/rr的发送者ssrc位于第4~7字节，rr的第一个报告块ssrc(即本端ssrc)位于第8~11字节
+    auto ptr = (uint8_t *)buf->data();
+    auto size = buf->size();
+    uint32_t ssrc[2] = { 0, 0 };
+    if (!is_rtcp && size >= 12) {
+        ssrc[0] = (ptr[8] << 24) | (ptr[9] << 16) | (ptr[10] << 8) | ptr[11];
+    } else if (is_rtcp && size >= 8) {
+        ssrc[0] = (ptr[4] << 24) | (ptr[5] << 16) | (ptr[6] << 8) | ptr[7];
+        if (size >= 12 && ptr[1] == 201 && (ptr[0] & 0x1F)) {
+            ssrc[1] = (ptr[8] << 24) | (ptr[9] << 16) | (ptr[10] << 8) | ptr[11];
+        }
+    }
+
+    bool learn_peer = false;
+    for (auto i = 0; !track && i < 2 && ssrc[i]; ++i) {
+        auto key = makeSSRCKey(peer_addr, ssrc[i]);
+        auto &shard = getShard(key);
+        lock_guard<mutex> lck(shard.mtx);
+        auto it = shard.ssrc_map.find(key);
+        //同一ip下多个track注册了该ssrc(播放同一个流)，无法区分，不能学习新端口
+        if (it != shard.ssrc_map.end() && it->second.size() == 1) {
+            track = it->second.front();
+            learn_peer = true;
+        }
+    }
+    if (!track) {
+        return;
+    }
+
+    if (learn_peer || (!is_rtcp && ssrc[0] && !track->has_ssrc)) {
+        //对端nat端口变化时记录新端口；推流时根据首个rtp包学习ssrc
+        lock_guard<mutex> lck(_mtx_shared_track);
+        if (!track->removed) {
+            if (learn_peer) {
+                addSharedPeer(track, peer);
+            } else if (!track->has_ssrc) {
+                addSharedSSRC(track, makeSSRCKey(peer_addr, ssrc[0]));
+            }
+        }
+    }
+
+    if (!track->cb(track->interleaved + (is_rtcp ? 1 : 0), buf, peer_addr)) {
+        stopListenSharedTrack(track->obj);
+    }
+}
+
 } /* namespace mediakit */
 
 
@@ -12,8 +12,11 @@
 #define RTSP_UDPSERVER_H_
 
 #include <stdint.h>
+#include <cstring>
 #include <mutex>
+#include <atomic>
 #include <memory>
+#include <vector>
 #include <unordered_map>
 #include "Network/Socket.h"
 
@@ -28,16 +31,101 @@ public:
     void listenPeer(const char *peer_ip, void *obj, const onRecvData &cb);
     void stopListenPeer(const char *peer_ip, void *obj);
 
+    /**
+     * 获取共享端口模式下该poller的rtp/rtcp socket(rtsp.udpSharedPort)
+     * 首次调用时在每个poller上绑定一对SO_REUSEPORT socket，由内核在各poller间分摊接收
+     * @return 未开启共享端口或者绑定失败时返回空
+     */
+    std::pair<toolkit::Socket::Ptr, toolkit::Socket::Ptr> getSharedSock(const toolkit::EventPoller::Ptr &poller);
+
+    /**
+     * 监听共享端口上某个track的rtp/rtcp数据
+     * 优先根据对端ip端口匹配，匹配不到时根据对端ip与ssrc匹配(对端nat映射端口发生变化)，并记录新的对端端口；
+     * 播放时ssrc为源的ssrc，同一ip下有多个会话注册了相同ssrc时无法区分，不做匹配
+     * @param obj 监听者，一般为RtspSession
+     * @param interleaved 该track的rtp interleaved，rtcp为interleaved + 1
+     * @param rtp_peer 对端rtp地址(SETUP时的client_port)
+     * @param rtcp_peer 对端rtcp地址
+     * @param ssrc 该track的ssrc，0表示未知，推流时会从首个rtp包学习
+     * @param cb 数据回调，返回false时取消该obj的所有监听
+     */
+    void listenSharedTrack(void *obj, int interleaved, const struct sockaddr *rtp_peer, const struct sockaddr *rtcp_peer, uint32_t ssrc, const onRecvData &cb);
+
+    /**
+     * 取消obj在共享端口上的所有监听
+     */
+    void stopListenSharedTrack(void *obj);
+
 private:
     UDPServer();
     void onRecv(int interleaved, const toolkit::Buffer::Ptr &buf, struct sockaddr *peer_addr);
     void onErr(const std::string &strKey, const toolkit::SockException &err);
 
+    //共享端口索引key，每个收包都要查找，所以不使用字符串
+    //ipv4地址统一转换为ipv4映射的ipv6地址(共享端口绑定在::上)，tail为端口(网络字节序)或ssrc
+    struct SharedKey {
+        uint8_t addr[16];
+        uint32_t tail;
+
+        bool operator==(const SharedKey &that) const {
+            return tail == that.tail && memcmp(addr, that.addr, sizeof(addr)) == 0;
+        }
+    };
+
+    struct SharedKeyHash {
+        size_t operator()(const SharedKey &key) const {
+            uint64_t high, low;
+            memcpy(&high, key.addr, 8);
+            memcpy(&low, key.addr + 8, 8);
+            uint64_t ret = (high * 0x9E3779B97F4A7C15ULL) ^ (low * 0xC2B2AE3D27D4EB4FULL) ^ key.tail;
+            return (size_t)(ret ^ (ret >> 31));
+        }
+    };
+
+    static SharedKey makeSharedKey(const struct sockaddr *addr, uint32_t tail);
+    static SharedKey makePeerKey(const struct sockaddr *addr);
+    static SharedKey makeSSRCKey(const struct sockaddr *addr, uint32_t ssrc);
+
+    struct SharedTrack {
+        using Ptr = std::shared_ptr<SharedTrack>;
+        void *obj;
+        int interleaved;
+        bool removed = false;
+        //是否已经注册ssrc，接收线程无锁判断是否需要学习ssrc
+        std::atomic<bool> has_ssrc { false };
+        onRecvData cb;
+        //该track注册的对端地址与对端ip+ssrc，取消监听时据此删除
+        std::vector<SharedKey> peers;
+        std::vector<SharedKey> ssrcs;
+    };
+
+    //对端地址与对端ip+ssrc索引按照哈希分片加锁，降低多个poller并发接收时的锁竞争
+    struct SharedShard {
+        std::mutex mtx;
+        std::unordered_map<SharedKey, SharedTrack::Ptr, SharedKeyHash> peer_map;
+        //同一key可能被多个track注册(例如同一ip下多个播放器播放同一个流)，只有唯一时才能匹配
+        std::unordered_map<SharedKey, std::vector<SharedTrack::Ptr>, SharedKeyHash> ssrc_map;
+    };
+
+    static constexpr size_t kSharedShardCount = 16;
+
+    void onRecvShared(bool is_rtcp, const toolkit::Buffer::Ptr &buf, struct sockaddr *peer_addr);
+    SharedShard &getShard(const SharedKey &key) { return _shared_shards[SharedKeyHash()(key) % kSharedShardCount]; }
+    void addSharedPeer(const SharedTrack::Ptr &track, const SharedKey &peer);
+    void addSharedSSRC(const SharedTrack::Ptr &track, const SharedKey &ssrc_key);
+
 private:
     std::mutex _mtx_udp_sock;
     std::mutex _mtx_on_recv;
     std::unordered_map<std::string, toolkit::Socket::Ptr> _udp_sock_map;
     std::unordered_map<std::string, std::unordered_map<void *, onRecvData> > _on_recv_map;
+
+    //共享端口模式，key为poller
+    std::unordered_map<toolkit::EventPoller *, std::pair<toolkit::Socket::Ptr, toolkit::Socket::Ptr> > _shared_sock_map;
+    //保护SharedTrack的peers/ssrcs/removed以及_shared_track_map
+    std::mutex _mtx_shared_track;
+    std::unordered_map<void *, std::vector<SharedTrack::Ptr> > _shared_track_map;
+    SharedShard _shared_shards[kSharedShardCount];
 };
 
 } /* namespace mediakit */
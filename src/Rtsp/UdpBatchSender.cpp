@@ -0,0 +1,177 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <atomic>
+#include <cstring>
+#include "UdpBatchSender.h"
+#include "Util/logger.h"
+
+#if defined(__linux__)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT 103
+#endif
+#ifndef SOL_UDP
+#define SOL_UDP 17
+#endif
+#define ENABLE_UDP_GSO
+#endif
+
+using namespace std;
+using namespace toolkit;
+
+namespace mediakit {
+
+#if defined(ENABLE_UDP_GSO)
+// 内核限制单次GSO最多64个分段
+static constexpr size_t kMaxGsoSegments = 64;
+// udp负载最大长度
+static constexpr size_t kMaxGsoBytes = 65507;
+static atomic<bool> s_gso_enabled { true };
+#else
+static atomic<bool> s_gso_enabled { false };
+#endif
+
+void UdpBatchSender::enableGso(bool enable) {
+#if defined(ENABLE_UDP_GSO)
+    s_gso_enabled = enable;
+#endif
+}
+
+bool UdpBatchSender::isGsoEnabled() {
+    return s_gso_enabled;
+}
+
+UdpBatchSender::UdpBatchSender(size_t offset) {
+    _offset = offset;
+    memset(&_peer_addr, 0, sizeof(_peer_addr));
+}
+
+void UdpBatchSender::setPeerAddr(const struct sockaddr *addr) {
+    switch (addr->sa_family) {
+        case AF_INET: memcpy(&_peer_addr, addr, sizeof(struct sockaddr_in)); break;
+        case AF_INET6: memcpy(&_peer_addr, addr, sizeof(struct sockaddr_in6)); break;
+        default: _have_peer = false; return;
+    }
+    _have_peer = true;
+}
+
+void UdpBatchSender::input(Buffer::Ptr buf) {
+    _packets.emplace_back(std::move(buf));
+}
+
+void UdpBatchSender::flush(const Socket::Ptr &sock) {
+    if (_packets.empty()) {
+        return;
+    }
+    size_t sent = 0;
+    // ZLToolKit发送队列中还有未发送的数据时，不能直接发送，否则会乱序
+    if (_have_peer && s_gso_enabled && !sock->isSocketBusy()) {
+        sent = sendGso(sock->rawFD());
+    }
+    if (sent < _packets.size()) {
+        sendBySocket(sock, sent);
+    }
+    _packet_count += _packets.size();
+    _packets.clear();
+}
+
+void UdpBatchSender::sendBySocket(const Socket::Ptr &sock, size_t index) {
+    socklen_t addr_len = _peer_addr.ss_family == AF_INET ? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6);
+    for (auto i = index; i < _packets.size(); ++i) {
+        //指定对端地址，以便与其他会话共享的socket(rtsp.udpSharedPort)也能正确发送
+        sock->send(std::make_shared<BufferOffset<Buffer::Ptr> >(std::move(_packets[i]), _offset),
+                   _have_peer ? (struct sockaddr *)&_peer_addr : nullptr, _have_peer ? addr_len : 0, false);
+    }
+    _fallback_count += _packets.size() - index;
+    sock->flushAll();
+}
+
+#if defined(ENABLE_UDP_GSO)
+static bool isGsoUnsupported(int err) {
+    switch (err) {
+        case EINVAL:
+        case EIO:
+        case EOPNOTSUPP:
+        case ENOPROTOOPT: return true;
+        default: return false;
+    }
+}
+#endif
+
+size_t UdpBatchSender::sendGso(int fd) {
+#if defined(ENABLE_UDP_GSO)
+    auto addr_len = _peer_addr.ss_family == AF_INET ? sizeof(struct sockaddr_in) : sizeof(struct sockaddr_in6);
+    struct iovec iov[kMaxGsoSegments];
+    char control[CMSG_SPACE(sizeof(uint16_t))];
+
+    size_t index = 0;
+    while (index < _packets.size()) {
+        // 收集连续等长的包作为一个GSO分组，最后一个分段可以比分段长度短
+        auto segment_size = _packets[index]->size() - _offset;
+        size_t count = 0;
+        size_t bytes = 0;
+        while (index + count < _packets.size() && count < kMaxGsoSegments) {
+            auto size = _packets[index + count]->size() - _offset;
+            if (size > segment_size || bytes + size > kMaxGsoBytes) {
+                break;
+            }
+            iov[count].iov_base = _packets[index + count]->data() + _offset;
+            iov[count].iov_len = size;
+            bytes += size;
+            ++count;
+            if (size < segment_size) {
+                break;
+            }
+        }
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_name = &_peer_addr;
+        msg.msg_namelen = addr_len;
+        msg.msg_iov = iov;
+        msg.msg_iovlen = count;
+        if (count > 1) {
+            memset(control, 0, sizeof(control));
+            msg.msg_control = control;
+            msg.msg_controllen = sizeof(control);
+            auto cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            *((uint16_t *)CMSG_DATA(cmsg)) = (uint16_t)segment_size;
+        }
+
+        ++_syscall_count;
+        if (sendmsg(fd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL) < 0) {
+            auto err = errno;
+            if (err != EAGAIN && err != EWOULDBLOCK && err != ENOBUFS && err != EINTR) {
+                // 对端不可达等错误(ECONNREFUSED/EHOSTUNREACH等)只计入本会话
+                ++_error_count;
+                if (count > 1 && isGsoUnsupported(err)) {
+                    // 内核或网卡不支持GSO，全局关闭GSO
+                    WarnL << "udp gso not supported, disable it: " << strerror(err);
+                    s_gso_enabled = false;
+                }
+            }
+            // 剩余的包交给ZLToolKit发送队列
+            break;
+        }
+        index += count;
+    }
+    return index;
+#else
+    return 0;
+#endif
+}
+
+} // namespace mediakit
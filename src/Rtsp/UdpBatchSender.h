@@ -0,0 +1,90 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_UDPBATCHSENDER_H
+#define ZLMEDIAKIT_UDPBATCHSENDER_H
+
+#include <vector>
+#include "Network/Socket.h"
+
+namespace mediakit {
+
+/**
+ * udp批量发送器，用于rtp over udp播放时把一个合并写列表的rtp包一次性发出
+ * linux下支持UDP_SEGMENT(GSO)时，把连续的等长rtp包合并为一次sendmsg，由内核/网卡切分为多个udp包；
+ * 不支持GSO、发送缓存满或者发送失败时，退化为ZLToolKit的发送队列(flushAll，linux下内部为sendmmsg)
+ */
+class UdpBatchSender {
+public:
+    /**
+     * @param offset 每个包需要跳过的头部长度(例如rtp over tcp的4字节interleaved头)
+     */
+    UdpBatchSender(size_t offset = 0);
+
+    /**
+     * 设置发送目标地址，应与socket bindPeerAddr的地址保持一致
+     */
+    void setPeerAddr(const struct sockaddr *addr);
+
+    /**
+     * 添加待发送的包，直到flush时才真正发送
+     */
+    void input(toolkit::Buffer::Ptr buf);
+
+    /**
+     * 发送所有缓存的包
+     */
+    void flush(const toolkit::Socket::Ptr &sock);
+
+    /**
+     * 已发送的包个数
+     */
+    uint64_t getPacketCount() const { return _packet_count; }
+
+    /**
+     * GSO路径下的发送系统调用次数(不包含退化到ZLToolKit发送队列的部分)
+     */
+    uint64_t getSyscallCount() const { return _syscall_count; }
+
+    /**
+     * 退化到ZLToolKit发送队列的包个数
+     */
+    uint64_t getFallbackCount() const { return _fallback_count; }
+
+    /**
+     * GSO路径下发送失败的次数(不包含发送缓存满)
+     */
+    uint64_t getErrorCount() const { return _error_count; }
+
+    /**
+     * 全局开关GSO，内核或网卡不支持时会自动关闭
+     */
+    static void enableGso(bool enable);
+    static bool isGsoEnabled();
+
+private:
+    // 采用GSO直接发送，返回已发送的包个数
+    size_t sendGso(int fd);
+    // 通过ZLToolKit发送队列发送[index, end)范围内的包
+    void sendBySocket(const toolkit::Socket::Ptr &sock, size_t index);
+
+private:
+    size_t _offset;
+    bool _have_peer = false;
+    struct sockaddr_storage _peer_addr;
+    uint64_t _packet_count = 0;
+    uint64_t _syscall_count = 0;
+    uint64_t _fallback_count = 0;
+    uint64_t _error_count = 0;
+    std::vector<toolkit::Buffer::Ptr> _packets;
+};
+
+} // namespace mediakit
+#endif // ZLMEDIAKIT_UDPBATCHSENDER_H
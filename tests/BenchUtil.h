@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#ifndef ZLMEDIAKIT_BENCHUTIL_H
+#define ZLMEDIAKIT_BENCHUTIL_H
+
+#include <new>
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+
+// test_bench_*压测程序公用的工具，每个压测程序为单独的可执行文件且只有一个源文件包含本头文件
+
+namespace mediakit {
+
+inline std::atomic<int> &benchFailedCount() {
+    static std::atomic<int> s_failed { 0 };
+    return s_failed;
+}
+
+/**
+ * 校验压测结果，失败时计数，main函数最后通过benchExitCode()返回
+ * @param ok 是否通过
+ * @param what 校验项描述
+ */
+inline bool benchCheck(bool ok, const std::string &what) {
+    if (!ok) {
+        ++benchFailedCount();
+    }
+    std::cout << (ok ? "[通过] " : "[失败] ") << what << std::endl;
+    return ok;
+}
+
+/**
+ * 所有校验项都通过时返回0，否则返回-1
+ */
+inline int benchExitCode() {
+    return benchFailedCount() ? -1 : 0;
+}
+
+#if defined(BENCH_COUNT_ALLOC)
+/**
+ * 全局operator new调用次数，定义BENCH_COUNT_ALLOC后替换全局operator new/delete
+ */
+inline std::atomic<uint64_t> &benchAllocCount() {
+    static std::atomic<uint64_t> s_alloc_count { 0 };
+    return s_alloc_count;
+}
+#endif
+
+} // namespace mediakit
+
+#if defined(BENCH_COUNT_ALLOC)
+// 全局operator new/delete的替换函数不能为inline，所以只能在一个源文件中包含
+void *operator new(size_t size) {
+    ++mediakit::benchAllocCount();
+    if (auto ptr = malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    free(ptr);
+}
+#endif
+
+#endif // ZLMEDIAKIT_BENCHUTIL_H
@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <cstring>
+#include <iostream>
+#include "Util/File.h"
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Extension/AnnexB.h"
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+// 优化前逐字节memcmp的查找实现
+static const char *memfind(const char *buf, ssize_t len, const char *subbuf, ssize_t sublen) {
+    for (auto i = 0; i < len - sublen; ++i) {
+        if (memcmp(buf + i, subbuf, sublen) == 0) {
+            return buf + i;
+        }
+    }
+    return NULL;
+}
+
+// 生成模拟码流: 每个nalu 4~64KB随机数据，插入防竞争字节后以00 00 00 01分隔
+static string makeBitstream(size_t bytes) {
+    string ret;
+    ret.reserve(bytes + 128 * 1024);
+    uint32_t seed = 1;
+    while (ret.size() < bytes) {
+        ret.append("\x00\x00\x00\x01", 4);
+        seed = seed * 1103515245 + 12345;
+        auto nalu_size = 4 * 1024 + (seed >> 8) % (60 * 1024);
+        int zero_count = 0;
+        for (size_t i = 0; i < nalu_size; ++i) {
+            seed = seed * 1103515245 + 12345;
+            // 提高0的比例以模拟真实码流
+            auto byte = (seed >> 16) % 4 ? (char)(seed >> 24) : 0;
+            if (zero_count >= 2 && (uint8_t)byte <= 3) {
+                ret.push_back(0x03);
+                zero_count = 0;
+            }
+            zero_count = byte ? 0 : zero_count + 1;
+            ret.push_back(byte);
+        }
+        if (!ret.back()) {
+            ret.push_back(0x80);
+        }
+    }
+    return ret;
+}
+
+// 返回每次循环的匹配个数
+template <typename FUNC>
+static size_t bench(const char *name, const string &data, size_t loop, FUNC &&find) {
+    size_t count = 0;
+    Ticker ticker;
+    for (size_t i = 0; i < loop; ++i) {
+        auto ptr = data.data();
+        auto end = data.data() + data.size();
+        while ((ptr = find(ptr, end))) {
+            ++count;
+            ptr += 3;
+        }
+    }
+    auto elapsed_ms = ticker.elapsedTime();
+    cout << name << " 匹配个数:" << count / loop
+         << " 耗时(ms):" << elapsed_ms
+         << " 速度(MB/s):" << data.size() * loop / 1024 / 1024 * 1000 / (elapsed_ms ? elapsed_ms : 1) << endl;
+    return count / loop;
+}
+
+//该测试程序用于压测Annex-B起始码查找性能，对比逐字节memcmp与findStartCode(SSE2/跳跃式标量实现)
+//用法: test_bench_annexb [h264/h265/ps码流文件路径] [循环次数]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LWarn));
+
+    auto data = argc > 1 ? File::loadFile(argv[1]) : makeBitstream(64 * 1024 * 1024);
+    size_t loop = argc > 2 ? atoi(argv[2]) : 10;
+    if (data.empty()) {
+        cout << "加载码流失败:" << argv[1] << endl;
+        return -1;
+    }
+
+    auto memfind_count = bench("memfind", data, loop, [](const char *ptr, const char *end) {
+        return memfind(ptr, end - ptr, "\x00\x00\x01", 3);
+    });
+    auto start_code_count = bench("findStartCode", data, loop, [](const char *ptr, const char *end) {
+        return findStartCode(ptr, end - 1);
+    });
+    benchCheck(memfind_count == start_code_count, "findStartCode与memfind查找结果一致");
+    return benchExitCode();
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Common/Stamp.h"
+#include "Common/MediaSource.h"
+#include "Extension/Frame.h"
+#define BENCH_COUNT_ALLOC
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+// 模拟的muxer个数(rtsp/rtmp/ts/fmp4/hls)
+static constexpr size_t kMuxerCount = 5;
+
+// 模拟一帧的转协议流程: 解复用器产生帧(不可缓存) -> 时间戳修正 -> 各muxer缓存帧
+template <typename MAKE_STAMP, typename MAKE_CACHE>
+static void inputFrame(const Frame::Ptr &frame, Stamp &stamp, MAKE_STAMP &&make_stamp, MAKE_CACHE &&make_cache) {
+    Frame::Ptr stamped = make_stamp(frame, stamp);
+    Frame::Ptr cache[kMuxerCount];
+    for (auto &item : cache) {
+        item = stamped->cacheAble() ? stamped : make_cache(stamped);
+    }
+}
+
+// 返回每帧内存分配次数
+template <typename MAKE_FRAME, typename MAKE_STAMP, typename MAKE_CACHE>
+static double bench(const char *name, size_t count, MAKE_FRAME &&make_frame, MAKE_STAMP &&make_stamp, MAKE_CACHE &&make_cache) {
+    // 模拟一帧h264 P帧
+    string payload(10 * 1024, '\0');
+    payload[2] = 1;
+    payload[3] = 0x41;
+    payload[4] = (char)0x80;
+
+    Stamp stamp;
+    uint64_t alloc_count = benchAllocCount();
+    Ticker ticker;
+    for (size_t i = 0; i < count; ++i) {
+        auto frame = make_frame(payload, i * 40);
+        inputFrame(frame, stamp, make_stamp, make_cache);
+    }
+    auto elapsed_ms = ticker.elapsedTime();
+    alloc_count = benchAllocCount() - alloc_count;
+    cout << name << " 帧数:" << count
+         << " 每帧内存分配次数:" << (double)alloc_count / count
+         << " 耗时(ms):" << elapsed_ms << endl;
+    return (double)alloc_count / count;
+}
+
+// 生产者线程创建帧，消费者线程(本线程)释放，返回最后一轮生产者的内存分配次数
+static uint64_t benchCrossThread(size_t count, size_t rounds) {
+    string payload(1024, '\0');
+    vector<Frame::Ptr> frames;
+    frames.reserve(count);
+    mutex mtx;
+    condition_variable cond;
+    bool produced = false;
+    uint64_t last_alloc_count = 0;
+
+    thread producer([&]() {
+        for (size_t round = 0; round < rounds; ++round) {
+            unique_lock<mutex> lock(mtx);
+            cond.wait(lock, [&]() { return !produced; });
+            uint64_t alloc_count = benchAllocCount();
+            for (size_t i = 0; i < count; ++i) {
+                frames.emplace_back(makeFrame<FrameFromPtr>(CodecH264, (char *)payload.data(), payload.size(), i, i, 4));
+            }
+            last_alloc_count = benchAllocCount() - alloc_count;
+            produced = true;
+            cond.notify_one();
+        }
+    });
+
+    for (size_t round = 0; round < rounds; ++round) {
+        unique_lock<mutex> lock(mtx);
+        cond.wait(lock, [&]() { return produced; });
+        // 在消费者线程释放，内存块归还到生产者线程
+        frames.clear();
+        produced = false;
+        cond.notify_one();
+    }
+    producer.join();
+    return last_alloc_count;
+}
+
+//该测试程序用于统计帧对象在转协议流程中每帧的内存分配次数，对比std::make_shared与makeFrame(线程局部内存池)
+//用法: test_bench_frame_alloc [帧数]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LWarn));
+
+    size_t count = argc > 1 ? atoi(argv[1]) : 1000 * 1000;
+
+    auto shared_allocs = bench("std::make_shared", count,
+        [](const string &payload, uint64_t dts) -> Frame::Ptr {
+            return std::make_shared<FrameFromPtr>(CodecH264, (char *)payload.data(), payload.size(), dts, dts, 4);
+        },
+        [](const Frame::Ptr &frame, Stamp &stamp) -> Frame::Ptr {
+            return std::make_shared<FrameStamp>(frame, stamp, ProtocolOption::kModifyStampRelative);
+        },
+        [](const Frame::Ptr &frame) -> Frame::Ptr { return std::make_shared<FrameCacheAble>(frame); });
+
+    auto pool_allocs = bench("makeFrame", count,
+        [](const string &payload, uint64_t dts) -> Frame::Ptr {
+            return makeFrame<FrameFromPtr>(CodecH264, (char *)payload.data(), payload.size(), dts, dts, 4);
+        },
+        [](const Frame::Ptr &frame, Stamp &stamp) -> Frame::Ptr {
+            return makeFrame<FrameStamp>(frame, stamp, ProtocolOption::kModifyStampRelative);
+        },
+        [](const Frame::Ptr &frame) -> Frame::Ptr { return Frame::getCacheAbleFrame(frame); });
+
+    // FrameFromPtr与FrameStamp两跳的分配被内存池消除，剩下的是FrameCacheAble拷贝数据的分配
+    benchCheck(pool_allocs + 2 <= shared_allocs, "makeFrame每帧内存分配次数至少比std::make_shared少2次");
+
+    auto cross_allocs = benchCrossThread(10 * 1000, 4);
+    cout << "跨线程释放 帧数:" << 10 * 1000 << " 最后一轮生产者内存分配次数:" << cross_allocs << endl;
+    benchCheck(cross_allocs < 10 * 1000 / 100, "跨线程释放的内存块归还到生产者线程后被复用");
+    return benchExitCode();
+}
@@ -0,0 +1,156 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <thread>
+#include <atomic>
+#include <iostream>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "Util/File.h"
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Network/sockutil.h"
+#include "Network/TcpServer.h"
+#include "Common/config.h"
+#include "Http/HttpSession.h"
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+#if defined(__linux__)
+
+static double getCpuSeconds(int who) {
+    struct rusage usage;
+    getrusage(who, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+// 通过keep-alive连接循环下载文件，只校验长度与最后一个字节，收到的数据直接丢弃
+static void download(uint16_t port, size_t seconds, int64_t file_size, atomic<uint64_t> &total_bytes, atomic<uint64_t> &errors, double &cpu_seconds) {
+    auto fd = SockUtil::connect("127.0.0.1", port, false);
+    if (fd < 0) {
+        cout << "连接服务器失败" << endl;
+        return;
+    }
+    static const char request[] = "GET /bench.bin HTTP/1.1\r\nHost: 127.0.0.1\r\nConnection: keep-alive\r\n\r\n";
+    char buf[256 * 1024];
+    uint64_t bytes = 0;
+    Ticker ticker;
+    while (ticker.elapsedTime() < seconds * 1000) {
+        if (::send(fd, request, sizeof(request) - 1, 0) <= 0) {
+            break;
+        }
+        // 解析http头获取Content-Length
+        string header;
+        int64_t remain = -1;
+        while (remain < 0) {
+            auto n = ::recv(fd, buf, sizeof(buf), 0);
+            if (n <= 0) {
+                goto exit;
+            }
+            header.append(buf, n);
+            auto pos = header.find("\r\n\r\n");
+            if (pos == string::npos) {
+                continue;
+            }
+            auto len_pos = header.find("Content-Length: ");
+            if (len_pos == string::npos || atoll(header.data() + len_pos + 16) != file_size) {
+                ++errors;
+                goto exit;
+            }
+            remain = file_size - (header.size() - pos - 4);
+            bytes += header.size() - pos - 4;
+        }
+        while (remain > 0) {
+            auto n = ::recv(fd, buf, MIN((int64_t)sizeof(buf), remain), 0);
+            if (n <= 0) {
+                ++errors;
+                goto exit;
+            }
+            remain -= n;
+            bytes += n;
+            if (!remain && buf[n - 1] != 'z') {
+                ++errors;
+            }
+        }
+    }
+exit:
+    cpu_seconds = getCpuSeconds(RUSAGE_THREAD);
+    total_bytes += bytes;
+    close(fd);
+}
+
+//该测试程序用于压测http文件下载性能，对比mmap拷贝发送与sendfile零拷贝发送的单核吞吐量
+//用法: test_bench_http_file [是否开启sendfile] [文件大小MB] [并发连接数] [压测时长秒]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LError));
+
+    bool send_file = argc > 1 ? atoi(argv[1]) : 1;
+    size_t file_mb = argc > 2 ? atoi(argv[2]) : 256;
+    size_t connections = argc > 3 ? atoi(argv[3]) : 8;
+    size_t seconds = argc > 4 ? atoi(argv[4]) : 10;
+
+    // 生成测试文件
+    auto root = exeDir() + "bench_www/";
+    File::create_path(root.data(), 0777);
+    {
+        auto fp = File::create_file((root + "bench.bin").data(), "wb");
+        string block(1024 * 1024, 'z');
+        for (size_t i = 0; i < file_mb; ++i) {
+            fwrite(block.data(), block.size(), 1, fp);
+        }
+        fclose(fp);
+    }
+    mINI::Instance()[Http::kRootPath] = root;
+    mINI::Instance()[Http::kSendFile] = send_file;
+    mINI::Instance()[Http::kAllowIPRange] = "";
+
+    TcpServer::Ptr server(new TcpServer());
+    server->start<HttpSession>(0);
+    auto port = server->getPort();
+
+    auto cpu_start = getCpuSeconds(RUSAGE_SELF);
+    atomic<uint64_t> total_bytes { 0 };
+    atomic<uint64_t> errors { 0 };
+    vector<double> client_cpu(connections, 0);
+    vector<thread> clients;
+    Ticker ticker;
+    for (size_t i = 0; i < connections; ++i) {
+        clients.emplace_back([&, i]() { download(port, seconds, file_mb * 1024 * 1024, total_bytes, errors, client_cpu[i]); });
+    }
+    for (auto &client : clients) {
+        client.join();
+    }
+    auto elapsed_ms = ticker.elapsedTime();
+
+    auto server_cpu = getCpuSeconds(RUSAGE_SELF) - cpu_start;
+    for (auto cpu : client_cpu) {
+        server_cpu -= cpu;
+    }
+    auto gbps = total_bytes * 8.0 / 1000 / 1000 / 1000 / (elapsed_ms / 1000.0);
+    cout << (send_file ? "sendfile" : "mmap") << " 并发连接数:" << connections << " 文件大小(MB):" << file_mb << endl
+         << "下载字节数:" << total_bytes << " 吞吐量(Gbps):" << gbps << endl
+         << "服务器cpu耗时(秒):" << server_cpu << " 每核吞吐量(Gbps):" << gbps * (elapsed_ms / 1000.0) / (server_cpu > 0 ? server_cpu : 1) << endl;
+
+    benchCheck(total_bytes > 0 && !errors, "所有回复的长度与内容正确");
+
+    server.reset();
+    File::delete_file((root + "bench.bin").data());
+    return benchExitCode();
+}
+
+#else
+int main(int argc, char *argv[]) {
+    cout << "sendfile only supported on linux" << endl;
+    return 0;
+}
+#endif // defined(__linux__)
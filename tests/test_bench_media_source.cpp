@@ -0,0 +1,122 @@
+﻿/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Common/config.h"
+#include "Common/MediaSource.h"
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+class BenchMediaSource : public MediaSource {
+public:
+    using Ptr = std::shared_ptr<BenchMediaSource>;
+    using MediaSource::MediaSource;
+    using MediaSource::regist;
+    int readerCount() override { return 0; }
+};
+
+static MediaTuple makeTuple(size_t index) {
+    return MediaTuple{DEFAULT_VHOST, "live", "stream_" + to_string(index), ""};
+}
+
+//该测试程序用于压测MediaSource::find在多线程查找同时有流注册注销时的性能
+//用法: test_bench_media_source [流个数] [查找线程数] [压测秒数]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LWarn));
+
+    size_t stream_count = argc > 1 ? atoi(argv[1]) : 20000;
+    size_t thread_count = argc > 2 ? atoi(argv[2]) : thread::hardware_concurrency();
+    size_t seconds = argc > 3 ? atoi(argv[3]) : 5;
+
+    vector<BenchMediaSource::Ptr> sources(stream_count);
+    for (size_t i = 0; i < stream_count; ++i) {
+        sources[i] = std::make_shared<BenchMediaSource>(RTSP_SCHEMA, makeTuple(i));
+        sources[i]->regist();
+    }
+
+    atomic<bool> exit_flag { false };
+    atomic<uint64_t> find_count { 0 };
+    atomic<uint64_t> hit_count { 0 };
+    atomic<uint64_t> churn_count { 0 };
+
+    vector<thread> threads;
+    for (size_t i = 0; i < thread_count; ++i) {
+        threads.emplace_back([&, i]() {
+            uint64_t finds = 0, hits = 0;
+            size_t index = i;
+            while (!exit_flag) {
+                index = (index * 1103515245 + 12345) % stream_count;
+                auto tuple = makeTuple(index);
+                if (MediaSource::find(RTSP_SCHEMA, tuple.vhost, tuple.app, tuple.stream)) {
+                    ++hits;
+                }
+                ++finds;
+            }
+            find_count += finds;
+            hit_count += hits;
+        });
+    }
+
+    //模拟流上下线
+    threads.emplace_back([&]() {
+        size_t index = 0;
+        while (!exit_flag) {
+            index = (index + 7) % stream_count;
+            sources[index] = nullptr;
+            sources[index] = std::make_shared<BenchMediaSource>(RTSP_SCHEMA, makeTuple(index));
+            sources[index]->regist();
+            ++churn_count;
+        }
+    });
+
+    Ticker ticker;
+    this_thread::sleep_for(chrono::seconds(seconds));
+    exit_flag = true;
+    for (auto &th : threads) {
+        th.join();
+    }
+    auto elapsed_ms = ticker.elapsedTime();
+
+    cout << "流个数:" << stream_count
+         << " 查找线程数:" << thread_count
+         << " 耗时(ms):" << elapsed_ms
+         << " 查找次数:" << find_count
+         << " 命中次数:" << hit_count
+         << " 注册注销次数:" << churn_count
+         << " 查找qps:" << find_count * 1000 / (elapsed_ms ? elapsed_ms : 1) << endl;
+
+    benchCheck(find_count > 0 && hit_count > 0, "查找线程有命中");
+    size_t missed = 0;
+    for (size_t i = 0; i < stream_count; ++i) {
+        auto tuple = makeTuple(i);
+        auto src = MediaSource::find(RTSP_SCHEMA, tuple.vhost, tuple.app, tuple.stream);
+        if (src != sources[i]) {
+            ++missed;
+        }
+    }
+    benchCheck(missed == 0, "注册注销结束后所有流都能找到且为最新注册的对象");
+
+    // app与stream_id中可能包含'/'，不同的tuple不能映射为同一个流
+    auto src_a = std::make_shared<BenchMediaSource>(RTSP_SCHEMA, MediaTuple{DEFAULT_VHOST, "a", "b/c", ""});
+    auto src_b = std::make_shared<BenchMediaSource>(RTSP_SCHEMA, MediaTuple{DEFAULT_VHOST, "a/b", "c", ""});
+    src_a->regist();
+    src_b->regist();
+    benchCheck(MediaSource::find(RTSP_SCHEMA, DEFAULT_VHOST, "a", "b/c") == src_a
+                 && MediaSource::find(RTSP_SCHEMA, DEFAULT_VHOST, "a/b", "c") == src_b, "包含'/'的app与stream_id不会冲突");
+    return benchExitCode();
+}
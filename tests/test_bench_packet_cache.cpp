@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <deque>
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Common/PacketCache.h"
+#include "Rtsp/Rtsp.h"
+#define BENCH_COUNT_ALLOC
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+using RtpList = toolkit::List<RtpPacket::Ptr>;
+
+// 改造前的合并写缓存: 每次flush都make_shared一个新的toolkit::List，每追加一个包分配一个链表节点
+class ListPacketCache {
+public:
+    ListPacketCache(std::function<void(std::shared_ptr<RtpList>)> cb) : _cb(std::move(cb)) {
+        _cache = std::make_shared<RtpList>();
+    }
+
+    void inputPacket(uint64_t stamp, bool is_video, RtpPacket::Ptr pkt, bool key_pos) {
+        if (_policy.isFlushAble(is_video, key_pos, stamp, _cache->size())) {
+            flush();
+        }
+        _cache->emplace_back(std::move(pkt));
+    }
+
+    void flush() {
+        if (_cache->empty()) {
+            return;
+        }
+        _cb(std::move(_cache));
+        _cache = std::make_shared<RtpList>();
+    }
+
+private:
+    FlushPolicy _policy;
+    std::shared_ptr<RtpList> _cache;
+    std::function<void(std::shared_ptr<RtpList>)> _cb;
+};
+
+// 改造后的合并写缓存: 包列表从回收池获取
+class PoolPacketCache : public PacketCache<RtpPacket> {
+public:
+    using List = PacketList<RtpPacket::Ptr>;
+
+    PoolPacketCache(std::function<void(std::shared_ptr<List>)> cb) : _cb(std::move(cb)) {}
+
+    void onFlush(std::shared_ptr<List> list, bool key_pos) override { _cb(std::move(list)); }
+
+private:
+    std::function<void(std::shared_ptr<List>)> _cb;
+};
+
+// 模拟环形缓存的gop缓存，保留最近gop_size个列表，更早的列表被释放(回收)
+template <typename CACHE, typename LIST>
+static double bench(const char *name, size_t frames, size_t rtp_per_frame, size_t gop_size) {
+    // rtp包预先创建，只统计合并写列表本身的内存分配
+    vector<RtpPacket::Ptr> packets(rtp_per_frame);
+    for (auto &rtp : packets) {
+        rtp = RtpPacket::create();
+    }
+
+    size_t flush_count = 0;
+    std::deque<std::shared_ptr<LIST> > gop;
+    CACHE cache([&](std::shared_ptr<LIST> list) {
+        ++flush_count;
+        gop.emplace_back(std::move(list));
+        if (gop.size() > gop_size) {
+            gop.pop_front();
+        }
+    });
+
+    // 预热，使回收池中的列表达到稳定容量
+    uint64_t stamp = 0;
+    auto input = [&](size_t count) {
+        for (size_t i = 0; i < count; ++i, stamp += 40) {
+            for (auto &rtp : packets) {
+                cache.inputPacket(stamp, true, rtp, false);
+            }
+        }
+    };
+    input(gop_size * 2);
+
+    auto flush_begin = flush_count;
+    uint64_t alloc_count = benchAllocCount();
+    Ticker ticker;
+    input(frames);
+    auto elapsed_ms = ticker.elapsedTime();
+    alloc_count = benchAllocCount() - alloc_count;
+    auto flushes = flush_count - flush_begin;
+    auto per_flush = (double)alloc_count / (flushes ? flushes : 1);
+    cout << name << " 帧数:" << frames
+         << " 每帧rtp包数:" << rtp_per_frame
+         << " 合并写次数:" << flushes
+         << " 每次合并写内存分配次数:" << per_flush
+         << " 耗时(ms):" << elapsed_ms << endl;
+    return per_flush;
+}
+
+//该测试程序用于统计合并写缓存每次flush的内存分配次数，对比每次新建toolkit::List与PacketList回收池
+//用法: test_bench_packet_cache [帧数] [每帧rtp包数]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LWarn));
+
+    size_t frames = argc > 1 ? atoi(argv[1]) : 100 * 1000;
+    size_t rtp_per_frame = argc > 2 ? atoi(argv[2]) : 8;
+    // 一个gop内的合并写次数小于回收池大小(64)
+    size_t gop_size = 50;
+
+    auto list_allocs = bench<ListPacketCache, RtpList>("toolkit::List", frames, rtp_per_frame, gop_size);
+    auto pool_allocs = bench<PoolPacketCache, PoolPacketCache::List>("ResourcePool", frames, rtp_per_frame, gop_size);
+
+    // 改造前每次flush至少分配列表对象与每个包的链表节点
+    benchCheck(list_allocs >= rtp_per_frame + 1, "toolkit::List每次合并写内存分配次数不少于包数+1");
+    // 回收池复用列表及其容量，只剩shared_ptr控制块等少量分配，与包数无关
+    benchCheck(pool_allocs <= 2, "回收池每次合并写内存分配次数不超过2次");
+    return benchExitCode();
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Extension/Factory.h"
+#include "Rtsp/RtspMuxer.h"
+#define BENCH_COUNT_ALLOC
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+// 返回每rtp包内存分配次数，不支持的编码返回负数
+static double bench(const char *name, CodecId codec, size_t count, size_t frame_size, size_t pool_size) {
+    auto encoder = Factory::getRtpEncoderByCodecId(codec, 96);
+    if (!encoder) {
+        cout << "不支持的编码:" << getCodecName(codec) << endl;
+        return -1;
+    }
+    encoder->setRtpInfo(0, 1400, codec == CodecAAC ? 44100 : 90000, 96);
+    encoder->getRtpInfo().setPacketPoolSize(pool_size);
+
+    // 模拟RtspMediaSource的rtp缓存，rtp包在缓存淘汰后释放
+    size_t rtp_count = 0;
+    vector<RtpPacket::Ptr> cache(512);
+    auto ring = std::make_shared<RtpRing::RingType>();
+    ring->setDelegate(std::make_shared<RingDelegateHelper>([&](RtpPacket::Ptr rtp, bool is_key) {
+        cache[rtp_count++ % cache.size()] = std::move(rtp);
+    }));
+    encoder->setRtpRing(ring);
+
+    // 模拟一帧h264/h265 P帧或aac帧
+    string payload(frame_size, '\x55');
+    auto prefix = 0;
+    switch (codec) {
+        case CodecH264: payload.replace(0, 5, "\x00\x00\x00\x01\x41", 5); prefix = 4; break;
+        case CodecH265: payload.replace(0, 6, "\x00\x00\x00\x01\x02\x01", 6); prefix = 4; break;
+        default: break;
+    }
+
+    uint64_t alloc_count = benchAllocCount();
+    Ticker ticker;
+    for (size_t i = 0; i < count; ++i) {
+        auto frame = Frame::getCacheAbleFrame(std::make_shared<FrameFromPtr>(codec, (char *)payload.data(), payload.size(), i * 40, i * 40, prefix));
+        encoder->inputFrame(frame);
+    }
+    auto elapsed_ms = ticker.elapsedTime();
+    alloc_count = benchAllocCount() - alloc_count;
+    cout << name << " 帧数:" << count
+         << " rtp包数:" << rtp_count
+         << " 每帧内存分配次数:" << (double)alloc_count / count
+         << " 每rtp包内存分配次数:" << (double)alloc_count / (rtp_count ? rtp_count : 1)
+         << " 耗时(ms):" << elapsed_ms << endl;
+    return (double)alloc_count / (rtp_count ? rtp_count : 1);
+}
+
+//该测试程序用于统计rtp打包时每帧的内存分配次数，对比每个rtp包重新分配与rtp包回收池
+//用法: test_bench_rtp_alloc [帧数] [帧大小]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LWarn));
+
+    size_t count = argc > 1 ? atoi(argv[1]) : 100 * 1000;
+    size_t frame_size = argc > 2 ? atoi(argv[2]) : 10 * 1024;
+
+    for (auto codec : { CodecH264, CodecH265, CodecAAC }) {
+        cout << getCodecName(codec) << ":" << endl;
+        auto create_allocs = bench("RtpPacket::create", codec, count, codec == CodecAAC ? 512 : frame_size, 0);
+        auto pool_allocs = bench("ResourcePool", codec, count, codec == CodecAAC ? 512 : frame_size, 1024);
+        if (create_allocs < 0) {
+            continue;
+        }
+        // 回收池只省掉RtpPacket对象与负载内存两次分配，shared_ptr控制块仍需分配
+        benchCheck(pool_allocs + 1 <= create_allocs, string(getCodecName(codec)) + " 回收池每rtp包内存分配次数至少少1次");
+    }
+    return benchExitCode();
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <iostream>
+#include <unordered_map>
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Rtsp/Rtsp.h"
+#include "Rtp/RtpSelector.h"
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+#if defined(ENABLE_RTPPROXY)
+
+// 优化前单把递归锁保护整个map的实现
+class LegacySelector {
+public:
+    RtpProcess::Ptr getProcess(const string &stream_id) {
+        lock_guard<recursive_mutex> lck(_mtx_map);
+        auto it = _map_rtp_process.find(stream_id);
+        return it == _map_rtp_process.end() ? nullptr : it->second;
+    }
+
+    void addProcess(const string &stream_id, const RtpProcess::Ptr &process) {
+        lock_guard<recursive_mutex> lck(_mtx_map);
+        _map_rtp_process[stream_id] = process;
+    }
+
+private:
+    recursive_mutex _mtx_map;
+    unordered_map<string, RtpProcess::Ptr> _map_rtp_process;
+};
+
+// 多线程并发按ssrc查找rtp处理器，统计每秒查找次数，返回未命中次数
+template <typename FUNC>
+static uint64_t bench(const char *name, const vector<string> &ids, size_t threads, size_t seconds, FUNC &&find) {
+    atomic<bool> exit_flag { false };
+    atomic<uint64_t> total { 0 };
+    atomic<uint64_t> missed { 0 };
+    vector<thread> workers;
+    for (size_t i = 0; i < threads; ++i) {
+        workers.emplace_back([&, i]() {
+            uint64_t count = 0, miss = 0;
+            uint32_t seed = i + 1;
+            while (!exit_flag) {
+                seed = seed * 1103515245 + 12345;
+                if (!find(ids[(seed >> 8) % ids.size()])) {
+                    ++miss;
+                }
+                ++count;
+            }
+            total += count;
+            missed += miss;
+        });
+    }
+    Ticker ticker;
+    this_thread::sleep_for(chrono::seconds(seconds));
+    exit_flag = true;
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    auto elapsed_ms = ticker.elapsedTime();
+    cout << name << " 线程数:" << threads
+         << " 查找次数:" << total
+         << " 未命中:" << missed
+         << " 每秒查找次数:" << total * 1000 / (elapsed_ms ? elapsed_ms : 1) << endl;
+    return missed;
+}
+
+//该测试程序模拟大量设备通过同一端口(openRtpServer的multiplex模式)推流，压测RtpSelector按ssrc查找的并发性能
+//用法: test_bench_rtp_selector [ssrc个数] [最大线程数] [每轮压测时长秒]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LError));
+
+    size_t count = argc > 1 ? atoi(argv[1]) : 5000;
+    size_t max_threads = argc > 2 ? atoi(argv[2]) : thread::hardware_concurrency();
+    size_t seconds = argc > 3 ? atoi(argv[3]) : 3;
+
+    // multiplex模式下未指定流id时，以ssrc作为流id
+    vector<string> ids;
+    LegacySelector legacy;
+    auto &selector = RtpSelector::Instance();
+    for (size_t i = 0; i < count; ++i) {
+        ids.emplace_back(printSSRC(0x10000000 + i));
+        legacy.addProcess(ids.back(), selector.getProcess(ids.back(), true));
+    }
+    cout << "ssrc个数:" << selector.size() << endl;
+    benchCheck(selector.size() == count, "所有ssrc都已创建rtp处理器");
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        bench("recursive_mutex", ids, threads, seconds, [&](const string &stream_id) {
+            return legacy.getProcess(stream_id);
+        });
+        auto missed = bench("RtpSelector", ids, threads, seconds, [&](const string &stream_id) {
+            return selector.getProcess(stream_id, false);
+        });
+        benchCheck(!missed, "RtpSelector " + to_string(threads) + "线程并发查找全部命中");
+    }
+    selector.clear();
+    benchCheck(selector.size() == 0, "清空后所有分片都为空");
+    return benchExitCode();
+}
+
+#else
+int main(int argc, char *argv[]) {
+    cout << "please ENABLE_RTPPROXY and then test" << endl;
+    return 0;
+}
+#endif // defined(ENABLE_RTPPROXY)
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <unistd.h>
+#include <sys/resource.h>
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Network/sockutil.h"
+#include "Rtsp/Rtsp.h"
+#include "Rtp/RtpServer.h"
+#include "Rtp/RtpSelector.h"
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+#if defined(ENABLE_RTPPROXY) && defined(__linux__)
+
+// rtp负载长度
+static constexpr size_t kRtpSize = 1400;
+
+// 读取/proc/net/snmp中的udp接收统计(InDatagrams与RcvbufErrors)
+static bool getUdpStatistic(uint64_t &in_datagrams, uint64_t &rcvbuf_errors) {
+    ifstream fs("/proc/net/snmp");
+    string line, header;
+    while (getline(fs, line)) {
+        if (line.compare(0, 4, "Udp:")) {
+            continue;
+        }
+        if (header.empty()) {
+            header = line;
+            continue;
+        }
+        istringstream keys(header), values(line);
+        string key, value;
+        while (keys >> key && values >> value) {
+            if (key == "InDatagrams") {
+                in_datagrams = stoull(value);
+            } else if (key == "RcvbufErrors") {
+                rcvbuf_errors = stoull(value);
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+static double getCpuSeconds(int who) {
+    struct rusage usage;
+    getrusage(who, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000000.0;
+}
+
+// 按照码率匀速向每个端口发送rtp(负载全0，仅压测接收路径，不涉及ps解复用)
+static void sendRtp(const vector<uint16_t> &ports, size_t kbps, size_t seconds, uint64_t &sent, double &cpu_seconds) {
+    auto fd = SockUtil::bindUdpSock(0, "127.0.0.1");
+    SockUtil::setSendBuf(fd, 8 * 1024 * 1024);
+    vector<double> quota(ports.size(), 0);
+    vector<uint16_t> seq(ports.size(), 0);
+    char rtp[RtpPacket::kRtpHeaderSize + kRtpSize] = { 0 };
+    auto header = (RtpHeader *)rtp;
+    header->version = RtpPacket::kRtpVersion;
+    header->pt = 96;
+
+    // 每10ms每路需发送的包数
+    auto packets_per_tick = kbps * 1000.0 / 8 / sizeof(rtp) / 100;
+    Ticker ticker;
+    for (size_t tick = 0; tick < seconds * 100; ++tick) {
+        for (size_t i = 0; i < ports.size(); ++i) {
+            auto addr = SockUtil::make_sockaddr("127.0.0.1", ports[i]);
+            header->ssrc = htonl(i + 1);
+            header->stamp = htonl(tick * 900);
+            for (quota[i] += packets_per_tick; quota[i] >= 1; quota[i] -= 1) {
+                header->seq = htons(seq[i]++);
+                if (::sendto(fd, rtp, sizeof(rtp), 0, (struct sockaddr *)&addr, sizeof(struct sockaddr_in)) > 0) {
+                    ++sent;
+                }
+            }
+        }
+        auto next_ms = (tick + 1) * 10;
+        auto now_ms = ticker.elapsedTime();
+        if (next_ms > now_ms) {
+            this_thread::sleep_for(chrono::milliseconds(next_ms - now_ms));
+        }
+    }
+    cpu_seconds = getCpuSeconds(RUSAGE_THREAD);
+    close(fd);
+}
+
+//该测试程序用于压测RtpServer(udp单端口单流模式)的接收性能，统计每个cpu核每秒处理的rtp包数
+//用法: test_bench_rtp_server [流个数] [每路码率kbps] [压测时长秒]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LError));
+
+    size_t count = argc > 1 ? atoi(argv[1]) : 1000;
+    size_t kbps = argc > 2 ? atoi(argv[2]) : 4000;
+    size_t seconds = argc > 3 ? atoi(argv[3]) : 10;
+
+    vector<RtpServer::Ptr> servers;
+    vector<uint16_t> ports;
+    for (size_t i = 0; i < count; ++i) {
+        auto server = std::make_shared<RtpServer>();
+        server->start(0, "bench_" + to_string(i), RtpServer::NONE, "127.0.0.1");
+        ports.emplace_back(server->getPort());
+        servers.emplace_back(std::move(server));
+    }
+
+    uint64_t in_datagrams = 0, rcvbuf_errors = 0;
+    getUdpStatistic(in_datagrams, rcvbuf_errors);
+    auto cpu_start = getCpuSeconds(RUSAGE_SELF);
+
+    uint64_t sent = 0;
+    double sender_cpu = 0;
+    thread sender([&]() { sendRtp(ports, kbps, seconds, sent, sender_cpu); });
+    sender.join();
+    // 等待接收完毕
+    this_thread::sleep_for(chrono::milliseconds(500));
+
+    auto server_cpu = getCpuSeconds(RUSAGE_SELF) - cpu_start - sender_cpu;
+    uint64_t in_datagrams_end = 0, rcvbuf_errors_end = 0;
+    getUdpStatistic(in_datagrams_end, rcvbuf_errors_end);
+    auto received = in_datagrams_end - in_datagrams;
+
+    cout << "流个数:" << count << " 每路码率(kbps):" << kbps << " 时长(秒):" << seconds << endl
+         << "发送包数:" << sent << " 接收包数:" << received << " 接收缓存溢出丢包:" << rcvbuf_errors_end - rcvbuf_errors << endl
+         << "接收cpu耗时(秒):" << server_cpu << " 每核每秒处理包数:" << (uint64_t)(received / (server_cpu > 0 ? server_cpu : 1)) << endl;
+
+    size_t dispatched = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (RtpSelector::Instance().getProcess("bench_" + to_string(i), false)) {
+            ++dispatched;
+        }
+    }
+    benchCheck(dispatched == count, "每路流的rtp都经批量接收分发到了RtpProcess");
+    benchCheck(received >= sent, "内核收到了所有发送的rtp包");
+    servers.clear();
+    return benchExitCode();
+}
+
+#else
+int main(int argc, char *argv[]) {
+    cout << "please ENABLE_RTPPROXY on linux and then test" << endl;
+    return 0;
+}
+#endif // defined(ENABLE_RTPPROXY) && defined(__linux__)
@@ -0,0 +1,194 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <map>
+#include <vector>
+#include <iostream>
+#include <functional>
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Rtsp/RtpReceiver.h"
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+// 优化前基于std::map的排序实现(简化版，保留插入、查找、删除以及计时的开销)
+class MapSortor {
+public:
+    void setOnSort(function<void(uint16_t, uint16_t)> cb) { _cb = std::move(cb); }
+
+    void sortPacket(uint16_t seq, uint16_t packet) {
+        if (!_started) {
+            _started = true;
+            _last_seq_out = seq - 1;
+        }
+        auto next_seq = static_cast<uint16_t>(_last_seq_out + 1);
+        if (seq == next_seq) {
+            output(seq, packet);
+            flushPacket();
+            return;
+        }
+        if (static_cast<uint16_t>(seq - next_seq) > 0x7FFF) {
+            return;
+        }
+        _cache.emplace(seq, packet);
+        if (_cache.size() > 256 || _ticker.elapsedTime() > 1000) {
+            auto it = _cache.begin();
+            output(it->first, it->second);
+            _cache.erase(it);
+            flushPacket();
+        }
+    }
+
+    void flush() {
+        for (auto &pr : _cache) {
+            output(pr.first, pr.second);
+        }
+        _cache.clear();
+    }
+
+private:
+    void flushPacket() {
+        auto it = _cache.begin();
+        while (it != _cache.end() && it->first == static_cast<uint16_t>(_last_seq_out + 1)) {
+            output(it->first, it->second);
+            it = _cache.erase(it);
+        }
+    }
+
+    void output(uint16_t seq, uint16_t packet) {
+        _last_seq_out = seq;
+        _cb(seq, packet);
+        _ticker.resetTime();
+    }
+
+private:
+    bool _started = false;
+    uint16_t _last_seq_out = 0;
+    Ticker _ticker;
+    map<uint16_t, uint16_t> _cache;
+    function<void(uint16_t, uint16_t)> _cb;
+};
+
+// 生成模拟的seq序列
+// loss: 丢包率(千分比), reorder: 乱序率(千分比), depth: 最大乱序深度
+static vector<uint16_t> makeSeqList(size_t count, int loss, int reorder, int depth) {
+    vector<uint16_t> ret;
+    ret.reserve(count);
+    uint32_t seed = 1;
+    auto rand = [&]() {
+        seed = seed * 1103515245 + 12345;
+        return (seed >> 16) & 0x7FFF;
+    };
+    // 从回环附近开始，覆盖seq回环的情况
+    uint16_t seq = 0xFFFF - 100;
+    for (size_t i = 0; i < count; ++seq, ++i) {
+        if ((int)(rand() % 1000) < loss) {
+            continue;
+        }
+        ret.emplace_back(seq);
+        if (depth > 0 && ret.size() > 1 && (int)(rand() % 1000) < reorder) {
+            // 把当前包往前挪若干个位置
+            auto pos = ret.size() - 1 - MIN(ret.size() - 1, 1 + rand() % depth);
+            ret.insert(ret.begin() + pos, seq);
+            ret.pop_back();
+        }
+    }
+    return ret;
+}
+
+struct BenchResult {
+    size_t output = 0;
+    // 输出seq未按顺序递增的次数
+    size_t disorder = 0;
+};
+
+template <typename SORTOR>
+static BenchResult bench(const char *name, const vector<uint16_t> &input, size_t loop) {
+    size_t output = 0;
+    size_t disorder = 0;
+    Ticker ticker;
+    for (size_t i = 0; i < loop; ++i) {
+        SORTOR sortor;
+        bool first = true;
+        uint16_t last_seq = 0;
+        sortor.setOnSort([&](uint16_t seq, uint16_t packet) {
+            if (!first && static_cast<uint16_t>(seq - last_seq - 1) > 0x7FFF) {
+                ++disorder;
+            }
+            first = false;
+            last_seq = seq;
+            ++output;
+        });
+        for (auto seq : input) {
+            sortor.sortPacket(seq, seq);
+        }
+        sortor.flush();
+    }
+    auto elapsed_ms = ticker.elapsedTime();
+    cout << name << " 输入个数:" << input.size()
+         << " 输出个数:" << output / loop
+         << " 耗时(ms):" << elapsed_ms
+         << " 包/秒:" << input.size() * loop * 1000 / (elapsed_ms ? elapsed_ms : 1) << endl;
+    BenchResult ret;
+    ret.output = output / loop;
+    ret.disorder = disorder / loop;
+    return ret;
+}
+
+//该测试程序用于压测rtp排序(抖动缓冲)性能，对比std::map与环形缓存实现
+//用法: test_bench_sortor [包数] [丢包率(千分比)] [乱序率(千分比)] [最大乱序深度] [循环次数]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LError));
+
+    size_t count = argc > 1 ? atoi(argv[1]) : 1000 * 1000;
+    int loss = argc > 2 ? atoi(argv[2]) : -1;
+    int reorder = argc > 3 ? atoi(argv[3]) : 0;
+    int depth = argc > 4 ? atoi(argv[4]) : 0;
+    size_t loop = argc > 5 ? atoi(argv[5]) : 10;
+
+    struct {
+        const char *name;
+        int loss;
+        int reorder;
+        int depth;
+    } cases[] = {
+        { "顺序到达", 0, 0, 0 },
+        { "乱序1%深度8", 0, 10, 8 },
+        { "丢包0.5%", 5, 0, 0 },
+        { "丢包1%+乱序5%深度32", 10, 50, 32 },
+    };
+
+    for (auto &c : cases) {
+        if (loss >= 0) {
+            // 使用命令行指定的参数
+            c.loss = loss;
+            c.reorder = reorder;
+            c.depth = depth;
+            c.name = "自定义";
+        }
+        auto input = makeSeqList(count, c.loss, c.reorder, c.depth);
+        cout << "###### " << c.name << " ######" << endl;
+        auto map = bench<MapSortor>("std::map", input, loop);
+        auto ring = bench<PacketSortor<uint16_t, uint16_t> >("PacketSortor", input, loop);
+        benchCheck(ring.disorder == 0, string(c.name) + " PacketSortor按seq顺序输出");
+        benchCheck(ring.output >= map.output, string(c.name) + " PacketSortor输出个数不少于std::map");
+        if (!c.loss && c.depth < 128) {
+            // 不丢包且乱序深度在排序窗口内时，不应丢弃任何包
+            benchCheck(ring.output == input.size(), string(c.name) + " PacketSortor输出所有包");
+        }
+        if (loss >= 0) {
+            break;
+        }
+    }
+    return benchExitCode();
+}
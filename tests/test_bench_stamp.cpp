@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <iostream>
+#include <unordered_map>
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Common/Stamp.h"
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+// 模拟视频25fps、音频50fps交替输入
+static constexpr int kVideoIndex = 0;
+static constexpr int kAudioIndex = 1;
+
+static void makeStamp(size_t i, int &index, int64_t &dts, int64_t &pts) {
+    if (i % 3 == 0) {
+        index = kVideoIndex;
+        dts = (i / 3) * 40;
+        // 模拟B帧
+        pts = dts + ((i / 3) % 2 ? 80 : 40);
+    } else {
+        index = kAudioIndex;
+        dts = pts = (i - i / 3 - 1) * 20;
+    }
+}
+
+template<typename STAMPS>
+static void setupStamps(STAMPS &stamps, bool playback, bool rollback, bool sync) {
+    auto &video = stamps[kVideoIndex];
+    auto &audio = stamps[kAudioIndex];
+    video.setPlayBack(playback);
+    audio.setPlayBack(playback);
+    video.enableRollback(rollback);
+    audio.enableRollback(rollback);
+    if (sync) {
+        audio.syncTo(video);
+    }
+}
+
+struct BenchResult {
+    uint64_t elapsed_ms = 0;
+    // 所有修正后时间戳之和，用于校验不同实现结果一致，同时防止被编译器优化掉
+    int64_t sum = 0;
+};
+
+template<typename STAMPS>
+static BenchResult benchRevise(size_t count, bool playback, bool rollback, bool sync) {
+    STAMPS stamps;
+    setupStamps(stamps, playback, rollback, sync);
+    int64_t dts_out, pts_out, sum = 0;
+    Ticker ticker;
+    for (size_t i = 0; i < count; ++i) {
+        int index;
+        int64_t dts, pts;
+        makeStamp(i, index, dts, pts);
+        stamps[index].revise(dts, pts, dts_out, pts_out);
+        sum += dts_out + pts_out;
+    }
+    BenchResult ret;
+    ret.elapsed_ms = ticker.elapsedTime();
+    ret.sum = sum;
+    return ret;
+}
+
+//该测试程序用于压测Stamp::revise的吞吐量，对比哈希表与数组直接寻址的track查找开销
+//用法: test_bench_stamp [帧数]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LWarn));
+
+    size_t count = argc > 1 ? atoi(argv[1]) : 10 * 1000 * 1000;
+    struct {
+        const char *name;
+        bool playback;
+        bool rollback;
+        bool sync;
+    } cases[] = {
+        { "直播", false, false, false },
+        { "直播+回退", false, true, false },
+        { "直播+音视频同步", false, false, true },
+        { "直播+回退+音视频同步", false, true, true },
+        { "回放", true, false, false },
+    };
+
+    for (auto &c : cases) {
+        auto map = benchRevise<unordered_map<int, Stamp> >(count, c.playback, c.rollback, c.sync);
+        auto flat = benchRevise<StampSet>(count, c.playback, c.rollback, c.sync);
+        cout << c.name << " 帧数:" << count
+             << " unordered_map(ms):" << map.elapsed_ms
+             << " StampSet(ms):" << flat.elapsed_ms
+             << " StampSet帧/秒:" << count * 1000 / (flat.elapsed_ms ? flat.elapsed_ms : 1) << endl;
+        benchCheck(flat.sum == map.sum, string(c.name) + " StampSet与unordered_map修正结果一致");
+    }
+    return benchExitCode();
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2016-present The ZLMediaKit project authors. All Rights Reserved.
+ *
+ * This file is part of ZLMediaKit(https://github.com/ZLMediaKit/ZLMediaKit).
+ *
+ * Use of this source code is governed by MIT-like license that can be found in the
+ * LICENSE file in the root of the source tree. All contributing project authors
+ * may be found in the AUTHORS file in the root of the source tree.
+ */
+
+#include <iostream>
+#include "Util/logger.h"
+#include "Util/TimeTicker.h"
+#include "Network/Socket.h"
+#include "Rtsp/Rtsp.h"
+#include "Rtsp/UdpBatchSender.h"
+#include "BenchUtil.h"
+
+using namespace std;
+using namespace toolkit;
+using namespace mediakit;
+
+// rtp负载长度
+static constexpr size_t kRtpSize = 1400;
+
+// 模拟一个合并写列表: 若干视频帧，每帧切分为多个等长rtp包，最后一个包较短
+static vector<Buffer::Ptr> makePacketList(size_t frames, size_t frame_size) {
+    vector<Buffer::Ptr> ret;
+    for (size_t i = 0; i < frames; ++i) {
+        for (size_t remain = frame_size; remain;) {
+            auto size = MIN(remain, kRtpSize);
+            auto buf = BufferRaw::create();
+            buf->setCapacity(size + RtpPacket::kRtpTcpHeaderSize);
+            buf->setSize(size + RtpPacket::kRtpTcpHeaderSize);
+            memset(buf->data(), 0, buf->size());
+            ret.emplace_back(std::move(buf));
+            remain -= size;
+        }
+    }
+    return ret;
+}
+
+struct BenchResult {
+    uint64_t packets = 0;
+    uint64_t syscalls = 0;
+    uint64_t elapsed_ms = 0;
+};
+
+static void print(const char *name, const BenchResult &result) {
+    cout << name << " 包数:" << result.packets;
+    if (result.syscalls) {
+        cout << " 系统调用次数:" << result.syscalls << " 系统调用/包:" << (double)result.syscalls / result.packets;
+    } else {
+        cout << " 系统调用次数:未知(由ZLToolKit决定，linux下为sendmmsg)";
+    }
+    cout << " 耗时(ms):" << result.elapsed_ms
+         << " 包/秒:" << result.packets * 1000 / (result.elapsed_ms ? result.elapsed_ms : 1) << endl;
+}
+
+//该测试程序用于压测rtp over udp播放的发送性能，统计每个rtp包的发送系统调用次数
+//对比逐包sendto、ZLToolKit发送队列(flushAll)与UdpBatchSender(UDP GSO)
+//用法: test_bench_udp_gso [合并写列表个数] [每个列表帧数] [帧大小]
+int main(int argc, char *argv[]) {
+    Logger::Instance().add(std::make_shared<ConsoleChannel>("ConsoleChannel", LWarn));
+
+    size_t loop = argc > 1 ? atoi(argv[1]) : 10000;
+    size_t frames = argc > 2 ? atoi(argv[2]) : 4;
+    size_t frame_size = argc > 3 ? atoi(argv[3]) : 20 * 1024;
+
+    auto poller = EventPollerPool::Instance().getPoller();
+    auto receiver = Socket::createSocket(poller, false);
+    auto sender = Socket::createSocket(poller, false);
+    if (!receiver->bindUdpSock(0, "127.0.0.1") || !sender->bindUdpSock(0, "127.0.0.1")) {
+        cout << "创建udp socket失败" << endl;
+        return -1;
+    }
+    // 接收端不读取数据，接收缓存满后内核直接丢包，不影响发送端
+    auto peer_addr = SockUtil::make_sockaddr("127.0.0.1", receiver->get_local_port());
+    sender->bindPeerAddr((struct sockaddr *)&peer_addr, 0, true);
+    auto list = makePacketList(frames, frame_size);
+
+    poller->sync([&]() {
+        BenchResult result;
+        Ticker ticker;
+        for (size_t i = 0; i < loop; ++i) {
+            for (auto &pkt : list) {
+                ::sendto(sender->rawFD(), pkt->data() + RtpPacket::kRtpTcpHeaderSize, pkt->size() - RtpPacket::kRtpTcpHeaderSize,
+                         0, (struct sockaddr *)&peer_addr, sizeof(struct sockaddr_in));
+                ++result.syscalls;
+            }
+        }
+        result.elapsed_ms = ticker.elapsedTime();
+        result.packets = loop * list.size();
+        print("逐包sendto", result);
+    });
+
+    poller->sync([&]() {
+        BenchResult result;
+        Ticker ticker;
+        for (size_t i = 0; i < loop; ++i) {
+            for (auto &pkt : list) {
+                sender->send(std::make_shared<BufferOffset<Buffer::Ptr> >(pkt, RtpPacket::kRtpTcpHeaderSize), nullptr, 0, false);
+            }
+            sender->flushAll();
+        }
+        result.elapsed_ms = ticker.elapsedTime();
+        result.packets = loop * list.size();
+        print("ZLToolKit flushAll", result);
+    });
+
+    poller->sync([&]() {
+        if (!UdpBatchSender::isGsoEnabled()) {
+            cout << "当前平台不支持UDP GSO" << endl;
+            return;
+        }
+        UdpBatchSender batch(RtpPacket::kRtpTcpHeaderSize);
+        batch.setPeerAddr((struct sockaddr *)&peer_addr);
+        Ticker ticker;
+        for (size_t i = 0; i < loop; ++i) {
+            for (auto &pkt : list) {
+                batch.input(pkt);
+            }
+            batch.flush(sender);
+        }
+        BenchResult result;
+        result.elapsed_ms = ticker.elapsedTime();
+        result.packets = batch.getPacketCount() - batch.getFallbackCount();
+        result.syscalls = batch.getSyscallCount();
+        print("UdpBatchSender(GSO)", result);
+        if (batch.getFallbackCount()) {
+            cout << "退化到ZLToolKit发送队列的包数:" << batch.getFallbackCount() << endl;
+        }
+        benchCheck(UdpBatchSender::isGsoEnabled() && batch.getErrorCount() == 0, "GSO发送无错误且未被关闭");
+        benchCheck(result.syscalls * 4 <= result.packets, "GSO路径每个系统调用至少发送4个rtp包");
+    });
+    return benchExitCode();
+}